@@ -0,0 +1,293 @@
+#include "GameSim.h"
+#include "Formation.h"
+#include "BulletPool.h"
+#include "Profiler.h"
+#include "Percentile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Micro y macro benchmarks de la simulación; salida en JSON para comparar builds.
+// uso: galaga_bench [--filter texto] [--min-time ms] [--ticks N] [--seed S] [--out results.json]
+
+// acceso a las piezas privadas que queremos medir por separado
+struct SimBenchAccess {
+    static bool rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b) { return GameSim::rectsIntersect(a, b); }
+    static void computeBounds(Formation& f) { f.computeBounds(); }
+    static bool stepCollisions(GameSim& sim) { return sim.stepCollisions(); }
+    static BulletPool& bullets(GameSim& sim) { return *sim.bullets_; }
+    static Formation& formation(GameSim& sim) { return *sim.formation_; }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// evita que el compilador descarte el resultado
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Options {
+    std::string filter;
+    double minTimeMs = 200.0;
+    std::uint64_t ticks = 20000;
+    std::uint32_t seed = 1;
+    std::string outPath;
+};
+
+struct MicroResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double nsPerOpMedian = 0.0;
+    double nsPerOpMin = 0.0;
+};
+
+struct MacroResult {
+    std::string name;
+    int scale = 1;
+    int enemies = 0;
+    std::uint64_t ticks = 0;
+    double ticksPerSec = 0.0;
+    double tickP50Us = 0.0;
+    double tickP99Us = 0.0;
+    int games = 0;
+    std::uint64_t kills = 0;
+    std::uint64_t pairs = 0;
+};
+
+// body(n) ejecuta n operaciones; se calibra n hasta que una muestra dure ~minTime/SAMPLES
+// y se devuelve la mediana y el mínimo de SAMPLES muestras
+MicroResult runMicro(const std::string& name, const Options& opt, const std::function<void(std::uint64_t)>& body) {
+    constexpr int SAMPLES = 9;
+    const double sampleNs = opt.minTimeMs * 1e6 / SAMPLES;
+    std::uint64_t n = 1;
+    for (;;) {
+        auto t0 = Clock::now();
+        body(n);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        if (ns >= sampleNs || n >= (1ull << 34)) break;
+        n = ns < sampleNs / 100.0 ? n * 10 : std::max<std::uint64_t>(n + 1, static_cast<std::uint64_t>(n * sampleNs / ns));
+    }
+    std::vector<double> perOp;
+    perOp.reserve(SAMPLES);
+    for (int s = 0; s < SAMPLES; ++s) {
+        auto t0 = Clock::now();
+        body(n);
+        perOp.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(n));
+    }
+    std::sort(perOp.begin(), perOp.end());
+    return MicroResult{ name, n * SAMPLES, perOp[SAMPLES / 2], perOp.front() };
+}
+
+// formación escalada: 10x y 100x reparten el factor entre columnas y filas
+// y agrandan el área de juego para que quepa
+SimConfig scaledConfig(int scale) {
+    SimConfig cfg;
+    int cols = 11, rows = 5;
+    if (scale == 10) { cols = 35; rows = 16; }       // 560 enemigos
+    else if (scale == 100) { cols = 110; rows = 50; } // 5500 enemigos
+    cfg.enemyCols = cols;
+    cfg.enemyRows = rows;
+    cfg.windowCols = std::max(cfg.windowCols, static_cast<int>(cols * 1.65f) + 6);
+    cfg.windowRows = std::max(cfg.windowRows, static_cast<int>(rows * 1.15f) + 20);
+    return cfg;
+}
+
+// entrada determinista: dispara siempre y barre de lado a lado
+SimInput sweepInput(std::uint64_t tick) {
+    SimInput in;
+    in.fire = true;
+    if ((tick / 240) % 2 == 0) in.right = true;
+    else in.left = true;
+    return in;
+}
+
+MacroResult runMacro(int scale, const Options& opt) {
+    MacroResult r;
+    r.name = "game." + std::to_string(scale) + "x";
+    r.scale = scale;
+    r.ticks = opt.ticks;
+    r.enemies = scaledConfig(scale).enemyCols * scaledConfig(scale).enemyRows;
+
+    GameSim sim(scaledConfig(scale), opt.seed);
+    const float dt = 1.f / 120.f;
+    std::vector<float> tickUs;
+    tickUs.reserve(opt.ticks);
+    auto start = Clock::now();
+    for (std::uint64_t t = 0; t < opt.ticks; ++t) {
+        auto t0 = Clock::now();
+        sim.step(sweepInput(t), dt);
+        tickUs.push_back(std::chrono::duration<float, std::micro>(Clock::now() - t0).count());
+        r.pairs += sim.stats().pairsTested;
+        for (const SimEvent& ev : sim.events())
+            if (ev.type == SimEventType::EnemyKilled) ++r.kills;
+        if (sim.isOver()) { ++r.games; sim.reset(); }
+    }
+    double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    r.ticksPerSec = secs > 0.0 ? static_cast<double>(opt.ticks) / secs : 0.0;
+    if (!tickUs.empty()) {
+        r.tickP50Us = percentile(tickUs.begin(), tickUs.end(), 0.50);
+        r.tickP99Us = percentile(tickUs.begin(), tickUs.end(), 0.99);
+    }
+    return r;
+}
+
+std::vector<MicroResult> runMicros(const Options& opt) {
+    std::vector<MicroResult> out;
+    auto wanted = [&](const std::string& name) { return opt.filter.empty() || name.find(opt.filter) != std::string::npos; };
+    std::mt19937 rng(opt.seed);
+
+    if (wanted("rectsIntersect")) {
+        // 1024 pares aleatorios: mitad se tocan aproximadamente
+        std::uniform_real_distribution<float> pos(0.f, 400.f), size(4.f, 60.f);
+        std::vector<sf::FloatRect> rects(2048);
+        for (sf::FloatRect& r : rects) r = sf::FloatRect({ pos(rng), pos(rng) }, { size(rng), size(rng) });
+        out.push_back(runMicro("rectsIntersect", opt, [&](std::uint64_t n) {
+            std::uint64_t hits = 0;
+            for (std::uint64_t i = 0; i < n; ++i) {
+                const std::size_t k = (i & 1023) * 2;
+                hits += SimBenchAccess::rectsIntersect(rects[k], rects[k + 1]);
+            }
+            keep(hits);
+        }));
+    }
+
+    if (wanted("Formation::update")) {
+        // recorrido normal por la pantalla del juego; cada pocos pasos rebota
+        SimConfig cfg;
+        const float right = static_cast<float>(cfg.virtualWidth()) - cfg.margin.x;
+        auto makeFormation = [&] { return Formation(cfg.enemyCols, cfg.enemyRows, { 76.f, 108.f }, 52.8f, 36.8f, cfg.enemySize, 40.f, 18.f); };
+        Formation f = makeFormation();
+        std::uint64_t calls = 0;
+        out.push_back(runMicro("Formation::update", opt, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                // el drop y la aceleración acumulan; se rehace la formación de vez en cuando
+                if (++calls % 4096 == 0) f = makeFormation();
+                f.update(1.f / 120.f, cfg.margin.x, right);
+            }
+            keep(f);
+        }));
+    }
+
+    if (wanted("Formation::computeBounds")) {
+        SimConfig cfg;
+        Formation f(cfg.enemyCols, cfg.enemyRows, { 76.f, 108.f }, 52.8f, 36.8f, cfg.enemySize);
+        // con las columnas de los extremos muertas, como a mitad de partida
+        for (int r = 0; r < cfg.enemyRows; ++r) {
+            f.kill(static_cast<std::size_t>(r * cfg.enemyCols));
+            f.kill(static_cast<std::size_t>(r * cfg.enemyCols + cfg.enemyCols - 1));
+        }
+        out.push_back(runMicro("Formation::computeBounds", opt, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) SimBenchAccess::computeBounds(f);
+            keep(f);
+        }));
+    }
+
+    if (wanted("collisions")) {
+        // 8 balas del jugador sobre enemigos al azar + el resto de la fase (balas enemigas, escudos)
+        GameSim sim(SimConfig{}, opt.seed);
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(SimBenchAccess::formation(sim).size()) - 1);
+        out.push_back(runMicro("sim.collisions", opt, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                Formation& f = SimBenchAccess::formation(sim);
+                if (f.aliveCount() < static_cast<int>(f.size() / 2)) f.reset();
+                BulletPool& bullets = SimBenchAccess::bullets(sim);
+                for (int b = 0; b < 8; ++b) bullets.acquire(f.position(static_cast<std::size_t>(pick(rng))), -480.f);
+                keep(SimBenchAccess::stepCollisions(sim));
+                bullets.clear();
+            }
+        }));
+    }
+
+    if (wanted("BulletPool")) {
+        // una op = llenar 128 huecos y soltarlos en orden aleatorio
+        BulletPool pool(256, { 8.4f, 15.f }, 256);
+        std::vector<BulletHandle> handles(128);
+        std::vector<std::uint32_t> order(128);
+        for (std::uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        out.push_back(runMicro("BulletPool::acquire+release x128", opt, [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                for (std::size_t k = 0; k < handles.size(); ++k) handles[k] = pool.acquire({ 10.f * static_cast<float>(k), 300.f }, -480.f);
+                for (std::uint32_t k : order) pool.release(handles[k]);
+            }
+            keep(pool);
+        }));
+    }
+    return out;
+}
+
+std::string toJson(const Options& opt, const std::vector<MicroResult>& micro, const std::vector<MacroResult>& macro) {
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(3);
+    os << "{\n  \"seed\": " << opt.seed << ",\n  \"profiling\": " << (GALAGA_PROFILING ? "true" : "false") << ",\n";
+    os << "  \"micro\": [";
+    for (std::size_t i = 0; i < micro.size(); ++i) {
+        const MicroResult& m = micro[i];
+        os << (i ? "," : "") << "\n    {\"name\": \"" << m.name << "\", \"iterations\": " << m.iterations
+           << ", \"ns_per_op\": " << m.nsPerOpMedian << ", \"ns_per_op_min\": " << m.nsPerOpMin << "}";
+    }
+    os << "\n  ],\n  \"macro\": [";
+    for (std::size_t i = 0; i < macro.size(); ++i) {
+        const MacroResult& m = macro[i];
+        os << (i ? "," : "") << "\n    {\"name\": \"" << m.name << "\", \"scale\": " << m.scale << ", \"enemies\": " << m.enemies
+           << ", \"ticks\": " << m.ticks << ", \"ticks_per_sec\": " << m.ticksPerSec
+           << ", \"tick_p50_us\": " << m.tickP50Us << ", \"tick_p99_us\": " << m.tickP99Us
+           << ", \"games\": " << m.games << ", \"kills\": " << m.kills << ", \"pairs\": " << m.pairs << "}";
+    }
+    os << "\n  ]\n}\n";
+    return os.str();
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else if (arg == "--min-time" && hasValue) opt.minTimeMs = std::strtod(argv[++i], nullptr);
+        else if (arg == "--ticks" && hasValue) opt.ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--out" && hasValue) opt.outPath = argv[++i];
+        else {
+            std::cerr << "usage: galaga_bench [--filter text] [--min-time ms] [--ticks N] [--seed S] [--out results.json]\n";
+            return 1;
+        }
+    }
+    if (opt.minTimeMs <= 0.0) opt.minTimeMs = 200.0;
+
+    std::vector<MicroResult> micro = runMicros(opt);
+    std::vector<MacroResult> macro;
+    for (int scale : { 1, 10, 100 }) {
+        std::string name = "game." + std::to_string(scale) + "x";
+        if (opt.filter.empty() || name.find(opt.filter) != std::string::npos) macro.push_back(runMacro(scale, opt));
+    }
+
+    const std::string json = toJson(opt, micro, macro);
+    if (opt.outPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(opt.outPath);
+        if (!out) { std::cerr << "could not write " << opt.outPath << "\n"; return 1; }
+        out << json;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// Contador global de reservas de memoria, para comprobar que un frame (o un tick) en régimen no
+// reserva nada. Solo con GALAGA_ALLOC_TRACKING=1 (opción de CMake, apagada por defecto):
+// entonces AllocTracker.cpp sustituye operator new/delete. Sin ella todo se queda a cero y las
+// zonas del Profiler no leen nada.
+#ifndef GALAGA_ALLOC_TRACKING
+#define GALAGA_ALLOC_TRACKING 0
+#endif
+
+class AllocTracker {
+public:
+    struct Counts {
+        std::uint64_t allocs = 0;
+        std::uint64_t frees = 0;
+        std::uint64_t bytes = 0; // pedidos a operator new en total
+    };
+
+    static constexpr bool enabled() { return GALAGA_ALLOC_TRACKING != 0; }
+    // las del hilo que llama, desde que arrancó
+    static Counts thisThread();
+    // las de todos los hilos
+    static Counts total();
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Decodifica imágenes y sonidos en un pool de hilos hacia buffers de CPU.
+// Con un AssetPack abierto lee de él (ya decodificado); si no, de los ficheros sueltos de assets/.
+// Nada de lo que hacen los hilos toca la GPU ni el dispositivo de audio: las subidas
+// (texturas, SoundBuffer) las hace el hilo principal con lo que devuelve poll().
+class AssetLoader {
+public:
+    enum class Kind { Image, Sound };
+
+    struct SoundData {
+        const std::int16_t* data = nullptr; // apunta a samples o, sin copia, al paquete mapeado
+        std::size_t count = 0;
+        std::vector<std::int16_t> samples;
+        unsigned int channelCount = 0;
+        unsigned int sampleRate = 0;
+        std::vector<sf::SoundChannel> channelMap;
+    };
+
+    struct Result {
+        std::string name;
+        std::string path;
+        Kind kind = Kind::Image;
+        bool ok = false;
+        sf::Image image;   // Kind::Image (ya reducida si se pidió maxSize)
+        SoundData sound;   // Kind::Sound
+    };
+
+    AssetLoader() = default;
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // el paquete debe vivir más que el loader y que los Result que apunten a él
+    void setPack(const class AssetPack* pack) { pack_ = pack; }
+
+    // encolar antes de start(); path relativo a assets/ ("textures/player.png")
+    void addImage(const std::string& name, const std::string& path, unsigned int maxSize = 0);
+    void addSound(const std::string& name, const std::string& path);
+
+    // threads == 0: núcleos disponibles menos uno (el principal sigue pintando)
+    void start(unsigned int threads = 0);
+
+    // siguiente resultado terminado, si hay; solo desde el hilo principal
+    std::optional<Result> poll();
+
+    std::size_t total() const { return jobs_.size(); }
+    std::size_t decoded() const { return decoded_.load(std::memory_order_acquire); }
+
+private:
+    struct Job {
+        std::string name;
+        std::string path;
+        Kind kind;
+        unsigned int maxSize;
+    };
+
+    const class AssetPack* pack_ = nullptr;
+    std::vector<Job> jobs_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> next_{0};
+    std::atomic<std::size_t> decoded_{0};
+    std::mutex doneMutex_;
+    std::deque<Result> done_;
+
+    void work();
+    Result run(const Job& job) const;
+};
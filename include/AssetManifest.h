@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+
+// Todo lo que el juego lee de assets/ (rutas relativas a esa carpeta). galaga_pack empaqueta
+// exactamente esto, con los sprites del atlas ya reducidos: lo que no aparece aquí (fondos sin
+// usar, explosion_boss.mp3...) no entra en assets.pak.
+struct AssetManifest {
+    // lado mayor (px) de cada sprite dentro del atlas; en pantalla miden <= 50 px
+    static constexpr unsigned int ATLAS_SPRITE_MAX = 128;
+    // sprites del atlas (textures/<nombre>.png), en el orden en que entran en él
+    // (así el atlas no depende de qué hilo de carga acabe antes)
+    static constexpr const char* ATLAS_SPRITES[] = { "player", "bullet", "bullet_2", "alien_top", "alien_mid", "alien_bottom" };
+    // a tamaño original: de él salen la máscara de colisión y la textura de los escudos
+    static constexpr const char* SHIELD = "textures/shield.png";
+    static constexpr const char* LASER_SOUND = "sounds/laser_sound.mp3";
+    static constexpr const char* EXPLOSION_SOUND = "sounds/explosion_enemy.mp3";
+    static constexpr const char* MUSIC = "music/bg_music.ogg";
+    static constexpr const char* FONT = "fonts/font.ttf";
+
+    static std::string spritePath(const char* name) { return std::string("textures/") + name + ".png"; }
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Formato de assets.pak (little-endian), generado en la build por galaga_pack:
+//   PackHeader | PackEntry[count] | datos (cada bloque alineado a PACK_ALIGN)
+// Las imágenes van ya decodificadas a RGBA y los efectos de sonido a PCM de 16 bits;
+// música y fuentes van tal cual porque se leen en streaming / bajo demanda.
+constexpr char PACK_MAGIC[4] = { 'G', 'P', 'A', 'K' };
+constexpr std::uint32_t PACK_VERSION = 1;
+constexpr std::uint64_t PACK_ALIGN = 64;
+
+enum class PackKind : std::uint32_t {
+    Raw = 0,  // bytes del fichero original (ogg, ttf...)
+    Rgba = 1, // param0 = ancho, param1 = alto
+    Pcm = 2   // int16 entrelazado; param0 = canales, param1 = frecuencia
+};
+
+struct PackHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+struct PackEntry {
+    char name[64];          // ruta relativa dentro de assets/, terminada en '\0'
+    PackKind kind;
+    std::uint32_t param0;
+    std::uint32_t param1;
+    std::uint32_t reserved;
+    std::uint64_t offset;   // desde el inicio del fichero
+    std::uint64_t size;     // bytes
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader debe ocupar 16 bytes");
+static_assert(sizeof(PackEntry) == 96, "PackEntry debe ocupar 96 bytes");
+
+// Paquete mapeado en memoria: las vistas apuntan directamente al fichero y valen
+// mientras el AssetPack siga vivo (sirven para loadFromMemory/openFromMemory sin copiar).
+class AssetPack {
+public:
+    struct View {
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        PackKind kind = PackKind::Raw;
+        std::uint32_t param0 = 0;
+        std::uint32_t param1 = 0;
+    };
+
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // name: ruta relativa dentro de assets/ ("textures/player.png")
+    std::optional<View> find(std::string_view name) const;
+
+private:
+    const std::uint8_t* base_ = nullptr;
+    std::size_t size_ = 0;
+    const PackEntry* entries_ = nullptr;
+    std::uint32_t count_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
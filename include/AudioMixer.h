@@ -0,0 +1,98 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "SpscQueue.h"
+
+// Mezclador de efectos por software: un único SoundStream (una voz del dispositivo) en el que
+// el hilo de audio suma todas las voces activas. El juego solo encola órdenes de reproducción
+// en una cola SPSC: play() no bloquea, no reserva memoria y no toca el dispositivo.
+// Con todas las voces ocupadas se roba la de menor prioridad y, a igualdad, la más antigua.
+class AudioMixer : public sf::SoundStream {
+public:
+    using ClipId = std::uint16_t;
+
+    struct Counters {
+        std::uint64_t played = 0;
+        std::uint64_t stolen = 0;  // voces cortadas para hacer sitio a otra
+        std::uint64_t dropped = 0; // órdenes descartadas (cola llena o sin voz que robar)
+        std::uint64_t mixMaxNs = 0; // bloque que más tardó en mezclarse (solo en takeFrame)
+    };
+
+    static constexpr unsigned int SAMPLE_RATE = 44100;
+    static constexpr unsigned int CHANNELS = 2;
+    static constexpr std::size_t CHUNK_FRAMES = 512; // ~11.6 ms por bloque
+    static constexpr std::size_t MAX_VOICES = 64;
+
+    explicit AudioMixer(std::size_t polyphony = 16);
+    ~AudioMixer() override;
+
+    // Solo con el mixer parado: el hilo de audio lee los clips sin sincronizar.
+    // Se convierte a estéreo a SAMPLE_RATE; borrow indica que samples vive más que el mixer
+    // (memoria del paquete mapeado) y, si el formato ya coincide, se usa sin copiar.
+    std::optional<ClipId> addClip(const std::int16_t* samples, std::size_t count, unsigned int channels,
+                                  unsigned int sampleRate, bool borrow = false);
+
+    // play() sin argumentos arranca el stream (SoundStream)
+    using sf::SoundStream::play;
+    // Desde el hilo principal. priority: mayor = más importante; volume en [0, 1]
+    void play(ClipId clip, std::uint8_t priority = 0, float volume = 1.f);
+
+    std::size_t polyphony() const { return polyphony_; }
+    std::size_t activeVoices() const { return active_.load(std::memory_order_relaxed); }
+    Counters totals() const;
+    // lo ocurrido desde la llamada anterior; una vez por frame desde el hilo principal
+    Counters takeFrame();
+
+protected:
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time) override {}
+
+private:
+    struct Clip {
+        const std::int16_t* data = nullptr; // estéreo entrelazado
+        std::size_t frames = 0;
+        std::vector<std::int16_t> owned;
+    };
+
+    struct Command {
+        ClipId clip = 0;
+        std::uint8_t priority = 0;
+        std::int32_t gain = 0; // Q15
+    };
+
+    struct Voice {
+        bool active = false;
+        ClipId clip = 0;
+        std::uint8_t priority = 0;
+        std::int32_t gain = 0;
+        std::size_t pos = 0;     // frame siguiente
+        std::uint32_t serial = 0; // orden de inicio: menor = más antigua
+    };
+
+    std::size_t polyphony_;
+    std::vector<Clip> clips_;
+
+    // productor: hilo principal; consumidor: hilo de audio
+    SpscQueue<Command, 64> commands_;
+
+    // solo los toca el hilo de audio
+    std::array<Voice, MAX_VOICES> voices_{};
+    std::uint32_t nextSerial_ = 0;
+    std::array<std::int32_t, CHUNK_FRAMES * CHANNELS> accum_{};
+    std::array<std::int16_t, CHUNK_FRAMES * CHANNELS> out_{};
+
+    std::atomic<std::size_t> active_{0};
+    std::atomic<std::uint64_t> played_{0};
+    std::atomic<std::uint64_t> stolen_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    // el hilo de audio no usa PROFILE_ZONE: su tiempo va aquí, sin bloqueos
+    std::atomic<std::uint64_t> mixMaxNs_{0};
+    Counters lastFrame_; // hilo principal
+
+    void start(const Command& cmd);
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include "EntityArrays.h"
+
+// Referencia estable a una bala: si el hueco se recicla, la generación cambia y el handle deja de valer.
+struct BulletHandle {
+    std::uint32_t index = UINT32_MAX;
+    std::uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+// Pool de balas en SoA con lista libre (acquire/release O(1)) y una lista densa de activas
+// para que update, colisiones y render solo toquen balas vivas.
+class BulletPool {
+public:
+    struct Stats {
+        std::size_t capacity = 0;
+        std::size_t highWater = 0;       // máximo de balas vivas a la vez
+        std::uint64_t failedAcquires = 0; // sin hueco y en el límite duro
+    };
+
+    BulletPool(std::size_t capacity = 0, const sf::Vector2f& size = {15.f, 15.f}, std::size_t hardLimit = 0);
+
+    // flown: segundos que ya lleva volando (disparos que tocaban antes del final del tick); la
+    // posición anterior queda en pos, así el barrido de colisiones empieza en la boca del cañón
+    BulletHandle acquire(const sf::Vector2f& pos, float speedY, float flown = 0.f);
+    void release(std::uint32_t index);
+    void release(BulletHandle h) { if (isAlive(h)) release(h.index); }
+    void clear();
+
+    void update(double dt);
+    void savePrevious();
+
+    bool isAlive(BulletHandle h) const {
+        return h.index < data_.size() && generation_[h.index] == h.generation && data_.alive[h.index];
+    }
+    BulletHandle handle(std::uint32_t index) const { return BulletHandle{ index, generation_[index] }; }
+
+    // índices de las balas vivas; release() mueve la última a la posición liberada,
+    // así que quien libere mientras recorre debe ir de atrás hacia delante
+    const std::vector<std::uint32_t>& active() const { return active_; }
+    sf::FloatRect bounds(std::uint32_t index) const { return data_.bounds(index); }
+    const EntityArrays& data() const { return data_; }
+    const Stats& stats() const { return stats_; }
+    std::size_t memoryBytes() const {
+        return data_.bytes() + (generation_.capacity() + freeList_.capacity() + active_.capacity() + denseIndex_.capacity()) * sizeof(std::uint32_t)
+             + originY_.capacity() * sizeof(float) + flight_.capacity() * sizeof(double);
+    }
+
+private:
+    EntityArrays data_;
+    std::vector<std::uint32_t> generation_;
+    // y = salida + velocidad · tiempo de vuelo (en double): sumar cada paso en float deriva distinto
+    // según el paso, y con ella cuál de dos objetivos casi a la vez recibe la bala
+    std::vector<float> originY_;
+    std::vector<double> flight_;
+    std::vector<std::uint32_t> freeList_;
+    std::vector<std::uint32_t> active_;
+    std::vector<std::uint32_t> denseIndex_; // hueco -> posición en active_
+    std::size_t hardLimit_;
+    Stats stats_;
+
+    bool grow();
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Datos de un tipo de entidad en arrays contiguos (SoA).
+// Las posiciones son centros; el tamaño (half) es común a todo el tipo.
+struct EntityArrays {
+    std::vector<float> x, y;
+    std::vector<float> prevX, prevY; // estado del tick anterior, para interpolar al dibujar
+    std::vector<float> vx, vy;
+    std::vector<std::uint8_t> alive;
+    sf::Vector2f half;
+
+    std::size_t size() const { return x.size(); }
+    // bytes reservados en los arrays (capacidad, no tamaño)
+    std::size_t bytes() const {
+        return (x.capacity() + y.capacity() + prevX.capacity() + prevY.capacity() + vx.capacity() + vy.capacity()) * sizeof(float)
+             + alive.capacity();
+    }
+
+    void clear() {
+        x.clear(); y.clear(); prevX.clear(); prevY.clear();
+        vx.clear(); vy.clear(); alive.clear();
+    }
+
+    void reserve(std::size_t n) {
+        x.reserve(n); y.reserve(n); prevX.reserve(n); prevY.reserve(n);
+        vx.reserve(n); vy.reserve(n); alive.reserve(n);
+    }
+
+    std::size_t push(float px, float py, bool isAlive = true) {
+        x.push_back(px); y.push_back(py);
+        prevX.push_back(px); prevY.push_back(py);
+        vx.push_back(0.f); vy.push_back(0.f);
+        alive.push_back(isAlive ? 1 : 0);
+        return x.size() - 1;
+    }
+
+    void savePrevious() {
+        prevX = x;
+        prevY = y;
+    }
+
+    sf::FloatRect bounds(std::size_t i) const {
+        return sf::FloatRect({ x[i] - half.x, y[i] - half.y }, { half.x * 2.f, half.y * 2.f });
+    }
+    sf::FloatRect previousBounds(std::size_t i) const {
+        return sf::FloatRect({ prevX[i] - half.x, prevY[i] - half.y }, { half.x * 2.f, half.y * 2.f });
+    }
+    // todo lo que barrió en el último tick, de la posición anterior a la actual
+    sf::FloatRect sweptBounds(std::size_t i) const {
+        const float x0 = std::min(prevX[i], x[i]);
+        const float y0 = std::min(prevY[i], y[i]);
+        return sf::FloatRect({ x0 - half.x, y0 - half.y },
+                             { std::abs(x[i] - prevX[i]) + half.x * 2.f, std::abs(y[i] - prevY[i]) + half.y * 2.f });
+    }
+};
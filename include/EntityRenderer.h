@@ -0,0 +1,85 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "SpriteBatch.h"
+#include "ShieldMask.h"
+#include "RenderSnapshot.h"
+
+enum class EntityKind {
+    Player,
+    PlayerBullet,
+    EnemyBullet,
+    AlienTop,
+    AlienMid,
+    AlienBottom,
+    Count
+};
+
+// Dibuja las entidades de una RenderSnapshot como quads en un SpriteBatch:
+// un draw por textura y capa, sin importar cuántas entidades haya.
+class EntityRenderer {
+public:
+    EntityRenderer();
+
+    void configure(const struct SimConfig& config);
+    void setTexture(EntityKind kind, const sf::Texture* tex);
+    // sub-rectángulo de una página de atlas
+    void setRegion(EntityKind kind, const sf::Texture* tex, const sf::FloatRect& rect);
+
+    // alpha: fracción entre el tick anterior (0) y el actual (1)
+    void draw(sf::RenderTarget& target, const RenderSnapshot& snap, float alpha);
+
+    const SpriteBatch::Stats& stats() const { return batch_.stats(); }
+
+    // Los escudos se pintan desde una textura propia (uno debajo de otro) que se sube solo
+    // por el rectángulo que cambió en cada máscara. img: shield.png, se muestrea al tamaño del escudo
+    void setShieldImage(const sf::Image& img);
+    std::uint64_t shieldTexelsUploaded() const { return shieldTexelsUploaded_; }
+
+    // fondo + escudos se componen en una capa estática a resolución virtual que se copia como un
+    // único quad; solo se rehace si un escudo cambia, si cambia la configuración o tras invalidateStatic()
+    void setBackgroundColor(const sf::Color& color) { backgroundColor_ = color; staticDirty_ = true; }
+    void invalidateStatic() { staticDirty_ = true; }
+    std::uint64_t staticRebuilds() const { return staticRebuilds_; }
+
+private:
+    struct KindVisual {
+        const sf::Texture* texture = nullptr;
+        sf::FloatRect texRect;
+        sf::Vector2f hitSize;   // tamaño en la simulación
+        sf::Vector2f drawSize;  // tamaño del quad (textura encajada en hitSize)
+        sf::Color fallbackColor = sf::Color::White;
+        bool stretch = false;   // estirar al tamaño exacto en vez de conservar proporción
+    };
+    std::array<KindVisual, static_cast<std::size_t>(EntityKind::Count)> kinds_;
+    SpriteBatch batch_;
+    bool singleTexture_ = false; // todo en la misma página: una sola pasada para todas las capas
+
+    sf::Vector2i shieldPixels_{0, 0};
+    sf::Texture shieldTexture_;
+    bool shieldTextureOk_ = false;
+    std::vector<std::uint8_t> shieldBase_;  // RGBA de un escudo intacto
+    std::vector<ShieldMask> shieldShown_;   // máscaras tal como están en la textura
+    std::vector<std::uint8_t> shieldScratch_;
+    std::uint32_t shieldRevision_ = 0;
+    std::uint64_t shieldTexelsUploaded_ = 0;
+
+    sf::RenderTexture staticLayer_;
+    std::optional<sf::Sprite> staticSprite_;
+    sf::Color backgroundColor_{18, 18, 28};
+    std::uint32_t staticRevision_ = 0;
+    bool staticDirty_ = true;
+    std::uint64_t staticRebuilds_ = 0;
+
+    KindVisual& visual(EntityKind kind) { return kinds_[static_cast<std::size_t>(kind)]; }
+    void rebuild(KindVisual& v);
+    void addQuad(const KindVisual& v, const sf::Vector2f& center, const sf::Color& tint = sf::Color::White);
+    void addSprites(const KindVisual& v, const RenderSnapshot::Sprites& sprites, float alpha);
+    void syncShields(const RenderSnapshot& snap);
+    void uploadShield(std::size_t index, const ShieldMask& mask, const sf::IntRect& rect);
+    void addShields(const RenderSnapshot& snap);
+    bool drawStatic(sf::RenderTarget& target, const RenderSnapshot& snap);
+};
@@ -1,37 +1,76 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include <cstdint>
 #include "Enemy.h"
+#include "EntityArrays.h"
 
 class Formation {
 public:
-    Formation(const sf::Texture* topTex,
-              const sf::Texture* midTex,
-              const sf::Texture* botTex,
-              int cols, int rows,
+    Formation(int cols, int rows,
               const sf::Vector2f& startPos,
               float spacingX, float spacingY,
+              const sf::Vector2f& enemySize = {45.f, 45.f},
               float speed = 60.f,
-              float dropAmount = 16.f);
+              float dropAmount = 16.f,
+              float bounceSpeedup = 1.07f);
 
-    void update(float dt, float screenLeft, float screenRight);
+    void update(double dt, float screenLeft, float screenRight);
+    // segundos hasta que el frente de la formación toque el borde hacia el que va (infinito si no
+    // queda nadie). GameSim parte el tick ahí para que el rebote y la bajada sean instantáneos
+    double timeToEdge(float screenLeft, float screenRight) const;
+    // rebota (baja, se da la vuelta y acelera) si el frente está en el borde; true si rebotó
+    bool bounceAtEdge(float screenLeft, float screenRight);
+    void savePrevious();
 
-    void draw(sf::RenderWindow& window) const;
+    // índice = fila * cols + columna
+    std::size_t size() const { return enemies_.size(); }
+    bool isAlive(std::size_t i) const { return enemies_.alive[i] != 0; }
+    void kill(std::size_t i);
+    sf::FloatRect bounds(std::size_t i) const { return enemies_.bounds(i); }
+    sf::Vector2f position(std::size_t i) const { return { enemies_.x[i], enemies_.y[i] }; }
+    EnemyKind kind(std::size_t i) const { return kinds_[i]; }
+    const EntityArrays& data() const { return enemies_; }
 
-    std::vector<Enemy>& enemies() { return enemies_; }
-    const std::vector<Enemy>& enemies() const { return enemies_; }
+    int cols() const { return cols_; }
+    std::size_t memoryBytes() const {
+        return enemies_.bytes() + kinds_.capacity() * sizeof(EnemyKind) + (occupancy_.capacity() + liveCols_.capacity()) * sizeof(std::uint64_t)
+             + (colCount_.capacity() + colBottom_.capacity()) * sizeof(int);
+    }
+    int rows() const { return rows_; }
 
     void reset();
+    // oleada nueva sobre los mismos arrays (mismo tamaño: no reserva nada)
+    void restart(float speed, float dropAmount);
     int aliveCount() const;
 
+    // columnas con al menos un enemigo vivo
+    int liveColumnCount() const;
+    // n-ésima columna viva (0 <= n < liveColumnCount()), de izquierda a derecha
+    int nthLiveColumn(int n) const;
+    // índice del enemigo vivo más bajo de la columna, o -1
+    int bottomAlive(int col) const { return colBottom_[static_cast<std::size_t>(col)]; }
+
 private:
+    friend struct SimBenchAccess;
+
+    void build();
+    void place();
     void computeBounds();
+    void bounce();
+    double gapToEdge(float screenLeft, float screenRight) const;
+
+    // px que el frente puede pasarse del borde sin que update rebote (redondeo al llegar justo)
+    static constexpr float EDGE_SLACK = 0.01f;
 
-    const sf::Texture* topTex_;
-    const sf::Texture* midTex_;
-    const sf::Texture* botTex_;
+    EntityArrays enemies_;
+    std::vector<EnemyKind> kinds_;
 
-    std::vector<Enemy> enemies_;
+    // bitboards en palabras de 64 bits: bit i = enemigo i vivo / bit c = columna c con vivos
+    std::vector<std::uint64_t> occupancy_;
+    std::vector<std::uint64_t> liveCols_;
+    std::vector<int> colCount_;
+    std::vector<int> colBottom_;
     int cols_;
     int rows_;
     sf::Vector2f startPos_;
@@ -39,9 +78,12 @@ private:
     float spacingY_;
 
     int dir_ = 1; // 1 right, -1 left
+    double offsetX_ = 0.0; // desplazamiento de toda la formación desde startPos_
+    double offsetY_ = 0.0;
     float speed_;
     float dropAmount_;
+    float bounceSpeedup_;
 
     float minX_ = 0.f;
     float maxX_ = 0.f;
-};
\ No newline at end of file
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <SFML/Window.hpp>
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+// Cómo se reparte el tiempo entre frames:
+//   Vsync    — display() espera al refresco (la latencia la decide la cola del driver)
+//   Uncapped — sin espera: tantos frames como dé la máquina
+//   Limited  — frame objetivo propio: duerme casi todo lo que sobra y gira el último tramo
+enum class PacingMode { Vsync, Uncapped, Limited };
+
+class FramePacer {
+public:
+    struct Stats {
+        float sleptUs = 0.f; // último frame
+        float spunUs = 0.f;
+        float lateUs = 0.f;  // cuánto se pasó del plazo (0 si llegó a tiempo)
+        float spinMarginUs = 0.f;
+    };
+
+    void configure(sf::Window& window, PacingMode mode, float targetHz);
+    // justo después de display()
+    void wait();
+
+    PacingMode mode() const { return mode_; }
+    float targetHz() const { return targetHz_; }
+    const Stats& stats() const { return stats_; }
+
+    // "vsync", "uncapped", "limit"
+    static std::optional<PacingMode> parse(std::string_view name);
+    static const char* name(PacingMode mode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // sleep nunca despierta antes, pero sí tarde: ese margen se gira en vez de dormirlo
+    static constexpr Clock::duration MIN_SPIN = std::chrono::microseconds(200);
+
+    PacingMode mode_ = PacingMode::Vsync;
+    float targetHz_ = 0.f;
+    Clock::duration period_{};
+    Clock::time_point lastEnd_{};
+    Clock::duration spinMargin_ = std::chrono::milliseconds(2);
+    Stats stats_;
+};
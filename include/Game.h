@@ -4,7 +4,13 @@
 #include <vector>
 #include <memory>
 #include <optional>
-#include <random>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include "GameSim.h"
+#include "InputActions.h"
+#include "FramePacer.h"
+#include "SimThread.h"
 
 class Game {
 public:
@@ -14,6 +20,37 @@ public:
     bool init();
     void run();
 
+    // paso fijo de la simulación, independiente del refresco de pantalla
+    void setTickRate(float hz);
+    void setMaxCatchUpTicks(int ticks);
+    // voces simultáneas del mezclador de efectos; antes de init()
+    void setPolyphony(std::size_t voices);
+    // graba la sesión (se guarda al cerrar) o reproduce una grabación en la ventana; antes de init()
+    void setRecordPath(const std::string& path) { recordPath_ = path; }
+    void setReplayPath(const std::string& path) { replayPath_ = path; }
+    // al terminar el replay vuelve al menú principal, lo deja en pantalla EXIT_MENU_FRAMES frames y
+    // cierra (pruebas guionizadas que acaban solas y pasan por la partida y por el menú)
+    void setExitAfterReplay(bool on) { exitAfterReplay_ = on; }
+    // reparto del tiempo entre frames (ver FramePacer); targetHz solo cuenta en PacingMode::Limited
+    void setPacing(PacingMode mode, float targetHz) { pacingMode_ = mode; pacingHz_ = targetHz; }
+    // CSV con la latencia de cada pulsación (ver LatencyProbe); antes de init()
+    void setLatencyLogPath(const std::string& path) { latencyLogPath_ = path; }
+    // fichero de teclas (ver InputBindings); antes de init()
+    void setBindingsPath(const std::string& path) { bindingsPath_ = path; }
+    // tamaño de la partida (formación, balas, ritmos de disparo, escudos); antes de init()
+    void setSimConfig(const SimConfig& config) { simConfig_ = config; }
+    // carga artificial en el hilo principal (ms por frame) para comprobar que el paso de la
+    // simulación no depende de lo que tarde el render
+    void setRenderStall(float ms);
+    // cuenta las reservas de memoria de cada frame en régimen (menú o partida, sin cambios de estado
+    // recientes ni overlay) y avisa de las que reservan; necesita GALAGA_ALLOC_TRACKING
+    void setAllocCheck(bool on) { allocCheck_ = on; }
+    // false si algún frame en régimen reservó memoria
+    bool allocCheckPassed() const { return allocFailedFrames_ == 0; }
+    // modo estrés: en vez de jugar mide `steps` tamaños, cada uno con el doble de enemigos, balas y
+    // ritmo de disparo que el anterior (partiendo de setSimConfig), imprime el informe y cierra
+    void setStressSweep(int steps, int frames, const std::string& csvPath);
+
 private:
     unsigned int windowWidth_;
     unsigned int windowHeight_;
@@ -23,79 +60,139 @@ private:
     unsigned int VIRTUAL_HEIGHT_;
     unsigned int MAX_CONTENT_WIDTH_ = 1280u;
 
+    // assets.pak mapeado; declarado antes que la fuente y la música porque leen de su memoria
+    std::unique_ptr<class AssetPack> pack_;
     sf::Font font_;
     bool hasFont_ = false;
-    sf::Texture texPlayer_, texBulletPlayer_, texBulletEnemy_;
-    sf::Texture texAlienTop_, texAlienMid_, texAlienBot_, texShield_;
+    std::unique_ptr<class TextureAtlas> atlas_;
+
+    // carga en segundo plano: los hilos decodifican, el principal sube por presupuesto
+    std::unique_ptr<class AssetLoader> loader_;
+    std::vector<std::pair<std::string, sf::Image>> loadedImages_;
+    std::size_t stagedAssets_ = 0;
+    bool assetsOk_ = true;
+    sf::Clock startupClock_;
+    bool interactiveLogged_ = false;
+    std::unique_ptr<class UiLayer> loadingUi_;
+    std::optional<std::size_t> loadingBarId_;
+    static constexpr sf::Vector2f LOADING_BAR_SIZE{ 360.f, 20.f };
+    static constexpr float UPLOAD_BUDGET_MS = 4.f; // trabajo de subida por frame durante la carga
     sf::Music bgMusic_;
-    sf::SoundBuffer laserBuf_;
-    std::optional<sf::Sound> laserSound_;
 
-    sf::SoundBuffer explosionBuf_;
-    bool explosionLoaded_ = false;
-    std::vector<sf::Sound> explosionSounds_;
-    size_t explosionSoundIndex_ = 0;
+    // efectos: un único stream que mezcla por software (ver AudioMixer)
+    std::unique_ptr<class AudioMixer> mixer_;
+    std::size_t polyphony_ = 16;
+    std::optional<std::uint16_t> laserClip_;
+    std::optional<std::uint16_t> explosionClip_;
+    // peor frame de la ventana del overlay
+    std::uint64_t peakStolen_ = 0;
+    std::uint64_t peakDropped_ = 0;
+    std::uint64_t peakMixNs_ = 0;
 
     std::unique_ptr<class Menu> menu_;
     std::unique_ptr<class Menu> pauseMenu_;
 
-    std::unique_ptr<class Formation> formation_;
-    std::vector<class Bullet> bullets_;
-    std::vector<class Bullet> enemyBullets_;
-    std::vector<class Shield> shields_;
-    std::unique_ptr<class Player> player_;
+    // la partida, la grabación y el replay se preparan aquí y al acabar la carga pasan al hilo de
+    // simulación (ver SimThread); desde entonces el principal solo ve sus Frames. El modo estrés
+    // no arranca el hilo y usa sim_ directamente
+    std::unique_ptr<class GameSim> sim_;
+    SimConfig simConfig_;
+    std::uint32_t seed_ = 0;
+    std::string recordPath_;
+    std::unique_ptr<class ReplayRecorder> recorder_;
+    std::string replayPath_;
+    std::unique_ptr<class Replay> replay_;
+    std::unique_ptr<SimThread> simThread_;
+    bool simAdvancing_ = false;    // último resume/pause enviado
+    bool simReplaying_ = false;    // el último Frame visto venía de un replay
+    bool exitAfterReplay_ = false;
+    static constexpr int EXIT_MENU_FRAMES = 240;
+    int exitCountdown_ = 0;        // frames hasta cerrar; 0 = no hay cierre pendiente
+    std::uint64_t shownTicks_ = 0; // Frame::ticks del último Frame visto
+    std::optional<SimThread::Press> heldPress_; // consumida en un tick que aún no se ha visto
+    float renderStallMs_ = 0.f;
+
+    // --alloc-check: reservas del hilo principal y de cada zona del Profiler (la simulación incluida)
+    static constexpr std::uint64_t ALLOC_SETTLE_FRAMES = 120; // tras un cambio de estado, ventana o overlay
+    static constexpr std::uint64_t ALLOC_REPORT_LIMIT = 10;
+    bool allocCheck_ = false;
+    std::uint64_t frameAllocStart_ = 0;
+    std::vector<std::uint64_t> zoneAllocsBefore_;
+    std::vector<std::uint64_t> zoneAllocsAfter_;
+    std::uint32_t allocScene_ = 0;       // estado, pausa y overlay del frame anterior
+    sf::Vector2u allocWindowSize_;
+    std::uint64_t allocSteadyFrames_ = 0; // frames seguidos con la misma escena
+    std::uint64_t allocCheckedFrames_ = 0;
+    std::uint64_t allocFailedFrames_ = 0;
+
+    // teclado -> acciones con marca de tiempo que el hilo de simulación consume en su tick
+    std::unique_ptr<class InputBindings> bindings_;
+    std::string bindingsPath_;
+    std::unique_ptr<class EntityRenderer> entityRenderer_;
+    // explosiones, impactos y fogonazos: salen de los eventos de la simulación, viven solo aquí
+    std::unique_ptr<class ParticleSystem> particles_;
+    std::unique_ptr<class StatsOverlay> statsOverlay_;
 
-    sf::RectangleShape musicBtn_;
-    std::optional<sf::Text> musicIcon_;
     bool musicOn_ = false;
     bool musicWasPlayingBeforeMenu_ = false;
 
-    std::optional<sf::Text> scoreText_;
-    std::optional<sf::Text> livesText_;
-    int score_ = 0;
-    int lives_ = 0;
+    // HUD y pantalla de resultado: capas retenidas, solo se re-rasterizan al cambiar
+    std::unique_ptr<class UiLayer> hud_;
+    std::unique_ptr<class UiLayer> resultUi_;
+    std::size_t musicBtnId_ = 0;
+    std::optional<std::size_t> musicIconId_;
+    std::optional<std::size_t> scoreTextId_;
+    std::optional<std::size_t> livesTextId_;
+    std::optional<std::size_t> overlayTitleId_;
+    std::optional<std::size_t> overlaySubId_;
+    int shownScore_ = -1;
+    int shownLives_ = -1;
 
     bool pausedForResult_ = false;
     bool paused_ = false;
-    std::optional<sf::Text> overlayTitle_;
-    std::optional<sf::Text> overlaySub_;
-
-    sf::Clock clock_;
-    float shootTimer_ = 0.f;
-    const float SHOOT_COOLDOWN = 0.6f;
-    const int SHIELD_HP = 15;
 
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> enemyShootDist_{0.8f, 1.8f};
-    std::uniform_int_distribution<int> enemyColDist_{0, 10};
-    float enemyShootTimer_ = 0.f;
+    PacingMode pacingMode_ = PacingMode::Vsync;
+    float pacingHz_ = 120.f;
+    std::unique_ptr<class FramePacer> pacer_;
+    std::unique_ptr<class LatencyProbe> latency_;
+    std::string latencyLogPath_;
 
-    enum class AppState { Menu, Playing };
+    sf::Clock clock_;
+    float tickDt_ = 1.f / 120.f;
+    int maxCatchUpTicks_ = 8;
+    int ticksLastFrame_ = 0;
+    // ventana de medida de los contadores por segundo del overlay
+    float statsElapsed_ = 0.f;
+    std::uint64_t lastShieldTexels_ = 0;
+    std::uint64_t lastStaticRebuilds_ = 0;
+
+    int stressSteps_ = 0;
+    int stressFrames_ = 600;
+    std::string stressCsvPath_;
+    static constexpr int STRESS_WARMUP_FRAMES = 120; // las balas tardan en llenar la pantalla
+
+    enum class AppState { Loading, Menu, Playing };
     AppState state_ = AppState::Menu;
 
     sf::Vector2f MARGIN_{12.f, 12.f};
-    const int WINDOW_COLS = 24;
-    const int WINDOW_ROWS = 25;
-    const int CELL_SIZE = 32;
-    const float HUD_HEIGHT = 64.f;
-    sf::Vector2f playerStart_;
 
-    static constexpr int ENEMY_COLS = 11;
-    static constexpr int ENEMY_ROWS = 5;
-
-    int wave_ = 1;
-
-    bool loadAssets();
+    void startLoading();
+    void pumpLoading();
+    void finishLoading();
     void createView();
     void updateGameViewForWindow(unsigned int winW, unsigned int winH);
-    std::unique_ptr<class Formation> createFormation();
     void resetGameState();
-    bool trySpawnFromColumn(int col);
-    static bool rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b);
-
-    void spawnNextWave();
+    void handleSimEvents();
+    void emitParticles(const SimEvent& ev, const std::vector<Shield>& shields);
+    void syncSim(bool advance);
+    void buildUi();
+    void syncHud(const RenderSnapshot& snap);
 
     void handleEvents();
     void update(float dt);
     void render();
+    void drawStats(float frameDt);
+    void runStress();
+    void beginFrameAllocs();
+    void checkFrameAllocs();
 };
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <string_view>
+#include "SpatialGrid.h"
+#include "ShieldMask.h"
+
+// Entrada de un tick: el que llama decide de dónde sale (teclado, bot, replay...)
+struct SimInput {
+    bool left = false;
+    bool right = false;
+    bool fire = false;
+};
+
+enum class SimEventType {
+    PlayerShot,
+    EnemyKilled,
+    ShieldHit,
+    PlayerHit,
+    GameOver,
+    WaveStarted
+};
+
+struct SimEvent {
+    SimEventType type;
+    sf::Vector2f position; // dónde pasó: centro del enemigo o del jugador al recibir el impacto, punto del impacto en el escudo
+    int value = 0; // score / lives / wave / escudo según el tipo
+};
+
+struct SimConfig {
+    sf::Vector2f margin{12.f, 12.f};
+    int windowCols = 24;
+    int windowRows = 25;
+    int cellSize = 32;
+    float hudHeight = 64.f;
+
+    int enemyCols = 11;
+    int enemyRows = 5;
+    int playerBullets = 64;       // capacidad inicial de cada pool
+    int enemyBullets = 32;
+    int playerBulletLimit = 1024;  // tope al que puede crecer
+    int enemyBulletLimit = 1024;
+    int shieldCount = 4;           // los que no caben bajo la formación se descartan
+    int craterRadius = 6;         // px que arranca cada bala al dar en un escudo
+    int startLives = 3;
+    float shootCooldown = 0.6f;
+    float enemyFireRate = 1.f;    // multiplica el ritmo de disparo enemigo (modo estrés: cientos de balas)
+    float enemySpacing = 1.f;     // escala del hueco entre enemigos; GameSim la reduce si la formación no cabe
+
+    // dificultad: la oleada 1 es la base y cada oleada siguiente suma un paso
+    float waveSpeedStep = 6.f;      // velocidad lateral de la formación
+    float waveDescendStep = 3.f;    // bajada en cada rebote
+    float bounceSpeedup = 1.07f;    // la formación acelera en cada rebote
+    float waveFireRateStep = 0.08f; // ritmo de disparo enemigo (fracción de la base)
+
+    // cajas de colisión: el tamaño con que se dibujan los sprites originales
+    sf::Vector2f enemySize{45.f, 45.f};
+    sf::Vector2f playerSize{50.f, 30.9f};
+    sf::Vector2f playerBulletSize{8.4f, 15.f};
+    sf::Vector2f enemyBulletSize{3.f, 15.f};
+    sf::Vector2f shieldSize{120.f, 60.f};
+
+    unsigned int virtualWidth() const { return static_cast<unsigned int>(margin.x * 2 + windowCols * cellSize); }
+    unsigned int virtualHeight() const { return static_cast<unsigned int>(margin.y + hudHeight + windowRows * cellSize + margin.y); }
+};
+
+// Opciones de línea de comandos comunes al juego y a las herramientas (tamaño de la partida).
+// false si flag no es una de ellas; los valores fuera de rango se ajustan
+bool applySimFlag(SimConfig& config, std::string_view flag, const char* value);
+constexpr const char* SIM_FLAGS_USAGE =
+    "[--cols N] [--rows N] [--player-bullets N] [--enemy-bullets N] [--fire-rate X] [--shoot-cooldown S] [--shields N]";
+
+// contadores del último step
+struct SimStats {
+    std::uint64_t pairsTested = 0; // pruebas de fase estrecha tras la rejilla
+    std::uint64_t sweptHits = 0;   // impactos a mitad de paso que la caja final ya no toca (se habrían atravesado)
+};
+
+class GameSim {
+public:
+    GameSim(const SimConfig& config = {}, std::uint32_t seed = std::random_device{}());
+    ~GameSim();
+
+    void reset();
+    // forma de los escudos (p. ej. el alfa de shield.png); sin llamarla se usa ShieldMask::bunker.
+    // Recrea los escudos; no toca el generador aleatorio
+    void setShieldShape(const ShieldMask& shape);
+    const ShieldMask& shieldShape() const { return shieldShape_; }
+    std::uint32_t shieldShapeHash() const { return shieldShape_.hash(); }
+    void step(const SimInput& input, float dt);
+
+    // eventos generados por el último step (se vacían al empezar el siguiente)
+    const std::vector<SimEvent>& events() const { return events_; }
+
+    int score() const { return score_; }
+    int lives() const { return lives_; }
+    int wave() const { return wave_; }
+    bool isOver() const { return over_; }
+    std::uint64_t tick() const { return tick_; }
+    const SimStats& stats() const { return stats_; }
+    // bytes reservados por la simulación (arrays, pools, rejillas, máscaras), sin contar el propio objeto
+    std::size_t memoryBytes() const;
+    // huella del estado que decide los ticks siguientes (para detectar divergencias en replays)
+    std::uint64_t checksum() const;
+
+    // la configuración efectiva: con formaciones enormes enemySize y enemySpacing ya vienen encogidos
+    const SimConfig& config() const { return config_; }
+    // huella de config(): una grabación solo se reproduce igual con la misma configuración
+    std::uint32_t configHash() const;
+    sf::Vector2f playerStart() const { return playerStart_; }
+
+    const class Formation* formation() const { return formation_.get(); }
+    const class BulletPool& bullets() const { return *bullets_; }
+    const class BulletPool& enemyBullets() const { return *enemyBullets_; }
+    const std::vector<class Shield>& shields() const { return shields_; }
+    // cambia cada vez que algún escudo pierde píxeles o se recrean (para cachés del render)
+    std::uint32_t shieldRevision() const { return shieldRevision_; }
+    const class Player* player() const { return player_.get(); }
+
+private:
+    friend struct SimBenchAccess; // bench/ mide las fases privadas sin hacerlas públicas
+
+    SimConfig config_;
+    sf::Vector2f playerStart_;
+    // lo que la entrada pide mover al jugador en el trozo en curso (sin contar los bordes)
+    sf::Vector2f playerStep_;
+
+    std::unique_ptr<class Formation> formation_;
+    std::unique_ptr<class BulletPool> bullets_;
+    std::unique_ptr<class BulletPool> enemyBullets_;
+    std::vector<class Shield> shields_;
+    ShieldMask shieldShape_;
+    ShieldMask crater_;
+    std::uint32_t shieldRevision_ = 0;
+    std::unique_ptr<class Player> player_;
+
+    int score_ = 0;
+    int lives_ = 0;
+    int wave_ = 1;
+    bool over_ = false;
+    std::uint64_t tick_ = 0;
+
+    // en double: se descuentan tick a tick y en float el redondeo acumulado (distinto según el paso)
+    // movía los disparos lo bastante para que una bala rozase o no a un enemigo
+    double shootTimer_ = 0.0;
+    double enemyShootTimer_ = 0.0;
+
+    std::mt19937 rng_;
+    std::uniform_real_distribution<float> enemyShootDist_{0.8f, 1.8f};
+    std::uniform_int_distribution<int> enemyColDist_;
+
+    std::vector<SimEvent> events_;
+    SimStats stats_;
+
+    SpatialGrid enemyGrid_;
+    SpatialGrid shieldGrid_;
+
+    // primer impacto de una bala dentro del trozo de tick (tiempo de impacto 0..1 del trozo)
+    struct Contact {
+        enum class Target : std::uint8_t { Enemy, Shield, Player };
+        float t = 0.f;
+        Target target = Target::Enemy;
+        bool enemyShot = false;
+        std::uint32_t bullet = 0;
+        std::uint32_t index = 0; // enemigo o escudo
+        int stamp = 0;           // píxeles del escudo / vidas al calcularlo: si cambian, se recalcula
+    };
+    // montículo por t: los impactos se resuelven en el orden en que ocurren dentro del tick
+    std::vector<Contact> contacts_;
+    std::vector<std::uint32_t> eroders_; // enemigos cuyo barrido del trozo toca algún escudo
+    float clearedAt_ = 1.f; // instante (0..1 del trozo) en que cayó el último enemigo
+
+    static constexpr std::size_t EVENT_RESERVE = 256; // eventos por tick sin que events_ crezca
+
+    void startFormation();
+    void fitFormation();
+    float nextEnemyShotDelay();
+    void spawnNextWave(double rest = 0.0);
+    void buildShields();
+    bool trySpawnFromColumn(int col);
+    void fireEnemyShot();
+    void firePlayerShot();
+    void savePrevious();
+    // el trozo en double: en float cada corte del tick redondearía distinto lo que se mueve todo
+    bool advance(const SimInput& input, double dt);
+    void stepMovement(double dt);
+    bool stepCollisions();
+    bool checkInvasion();
+    void rebuildEnemyGrid();
+    int firstShieldHit(const sf::FloatRect& box);
+    void erodeShields(const sf::FloatRect& swept, sf::Vector2f front);
+    void erodeUntil(std::size_t e, float t);
+    bool playerShotContact(std::uint32_t i, Contact& out);
+    bool enemyShotContact(std::uint32_t i, Contact& out);
+    bool shieldContact(const sf::FloatRect& start, float dy, Contact& out);
+    bool contactStale(const Contact& c) const;
+    bool applyContact(const Contact& c);
+    void emit(SimEventType type, const sf::Vector2f& pos, int value = 0);
+    static bool rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b);
+};
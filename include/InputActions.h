@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "GameSim.h"
+
+// Acciones del jugador, independientes de la tecla que las dispare (ver InputBindings).
+// Las tres primeras llegan a la simulación tick a tick; el resto las atiende Game al momento.
+enum class Action : std::uint8_t {
+    Left,
+    Right,
+    Fire,
+    Pause,
+    Confirm,
+    MenuUp,
+    MenuDown,
+    ToggleStats,
+    WriteTrace,
+    CyclePacing,
+    Count
+};
+
+constexpr std::size_t ACTION_COUNT = static_cast<std::size_t>(Action::Count);
+constexpr std::size_t GAMEPLAY_ACTION_COUNT = 3;
+constexpr bool isGameplayAction(Action a) { return static_cast<std::size_t>(a) < GAMEPLAY_ACTION_COUNT; }
+
+// "left", "right", "fire", "pause", "confirm", "up", "down", "stats", "trace", "pacing"
+std::optional<Action> parseAction(std::string_view name);
+const char* actionName(Action a);
+
+struct ActionEvent {
+    std::uint64_t timeNs; // reloj de actionClockNs(); 0 = ya vencido
+    Action action;
+    bool pressed;
+};
+
+// reloj monotónico con que se marcan los eventos
+std::uint64_t actionClockNs();
+
+// Cola circular de eventos de acción en orden de llegada, sin sincronización: la usa un solo
+// hilo, el de simulación (SimThread la llena con lo que le llega de la ventana por su cola SPSC).
+// Llena, descarta el más antiguo y lo cuenta.
+class ActionRing {
+public:
+    static constexpr std::size_t CAPACITY = 256;
+
+    void push(const ActionEvent& ev);
+    bool empty() const { return count_ == 0; }
+    std::size_t size() const { return count_; }
+    const ActionEvent& front() const { return events_[head_]; }
+    void pop();
+    void clear() { head_ = 0; count_ = 0; }
+    std::uint64_t overflowed() const { return overflowed_; }
+
+private:
+    std::array<ActionEvent, CAPACITY> events_{};
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    std::uint64_t overflowed_ = 0;
+};
+
+// Estado de las acciones de juego entre ticks: teclas mantenidas más las pulsadas desde el
+// último tick, para que un toque más corto que un tick no se pierda.
+class ActionState {
+public:
+    void apply(Action a, bool pressed);
+    // entrada del tick (izquierda gana a derecha, como siempre) y olvida los toques ya usados
+    SimInput takeTick();
+    bool held(Action a) const { return isGameplayAction(a) && held_[static_cast<std::size_t>(a)]; }
+
+private:
+    std::array<bool, GAMEPLAY_ACTION_COUNT> held_{};
+    std::array<bool, GAMEPLAY_ACTION_COUNT> tapped_{};
+};
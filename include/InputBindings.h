@@ -0,0 +1,33 @@
+#pragma once
+#include <SFML/Window.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "InputActions.h"
+
+// Qué acciones dispara cada tecla. Una tecla puede disparar varias (Space: disparar y confirmar).
+// Fichero de texto, una acción por línea (# comenta):
+//   fire = Space, LControl
+//   left = Left, A
+// Las acciones que aparecen sustituyen a sus teclas por defecto; las demás se quedan como están.
+class InputBindings {
+public:
+    InputBindings(); // por defecto: flechas o A/D, Space, Escape, Enter/Space, flechas en los menús, F3, F4, F5
+
+    void bind(sf::Keyboard::Key key, Action action);
+    void unbindAll(Action action);
+    // bits (1 << Action) de las acciones de la tecla
+    std::uint32_t actions(sf::Keyboard::Key key) const;
+    // alguna de las teclas de la acción está pulsada ahora mismo (para resincronizar tras una pausa)
+    bool isHeld(Action action) const;
+
+    bool load(const std::string& path);
+
+    // nombre del enumerado de SFML: "A", "Num1", "Space", "Left", "F3"...
+    static std::optional<sf::Keyboard::Key> parseKey(std::string_view name);
+
+private:
+    std::array<std::uint32_t, sf::Keyboard::KeyCount> masks_{};
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Latencia de entrada de punta a punta, con tres marcas por pulsación (reloj de actionClockNs()):
+//   input   — el evento de teclado llegó (se sacó de la cola de la ventana)
+//   tick    — el tick de la simulación que lo aplicó
+//   display — volvió el display() del primer frame dibujado después de ese tick
+// "display" es lo más cerca de los fotones que se puede medir sin sensor: con vsync y cola del
+// driver la imagen aún puede tardar uno o dos refrescos en salir.
+class LatencyProbe {
+public:
+    struct Percentiles {
+        float p50 = 0.f;
+        float p95 = 0.f;
+        float p99 = 0.f;
+    };
+    struct Summary {
+        Percentiles inputToTick;
+        Percentiles tickToDisplay;
+        Percentiles inputToDisplay;
+        std::size_t samples = 0; // en la ventana
+        std::uint64_t total = 0; // desde el principio
+    };
+
+    LatencyProbe();
+
+    void consumed(std::uint64_t inputNs, std::uint64_t tickNs);
+    void displayed(std::uint64_t displayNs);
+
+    // percentiles de las últimas WINDOW pulsaciones, en ms
+    Summary summarize() const;
+
+    // CSV con una fila por pulsación (input_ns,tick_ns,display_ns)
+    bool openLog(const std::string& path);
+
+private:
+    static constexpr std::size_t WINDOW = 512;
+    static constexpr std::size_t PENDING_RESERVE = 64; // pulsaciones entre dos frames mostrados
+
+    struct Pending {
+        std::uint64_t input;
+        std::uint64_t tick;
+    };
+    std::vector<Pending> pending_;
+    std::array<float, WINDOW> inputToTick_{};
+    std::array<float, WINDOW> tickToDisplay_{};
+    std::array<float, WINDOW> inputToDisplay_{};
+    std::uint64_t count_ = 0;
+    std::ofstream log_;
+};
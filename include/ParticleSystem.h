@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Partículas de efecto (explosiones, impactos, fogonazos): solo visuales, fuera de la simulación.
+// Pool de capacidad fija en estructura de arrays: las vivas ocupan [0, size()) y la que muere se
+// tapa con la última. update() recorre arrays contiguos sin ramas (el compilador lo vectoriza) y
+// draw() manda todas las vivas en un único draw. Todo se reserva en el constructor: con el pool
+// lleno las ráfagas nuevas se recortan en vez de crecer.
+class ParticleSystem {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 32768;
+
+    // forma de una ráfaga; la dirección de cada partícula sale al azar dentro del abanico
+    struct Burst {
+        int count = 16;
+        float angle = 0.f;             // centro del abanico (rad, 0 = derecha, y hacia abajo)
+        float spread = 6.2831853f;     // apertura total (rad); 2π = en todas direcciones
+        float speedMin = 40.f;         // px/s
+        float speedMax = 160.f;
+        float lifeMin = 0.3f;          // s
+        float lifeMax = 0.7f;
+        float size = 3.f;              // lado del quad al nacer (px); al morir, la mitad
+        float drag = 2.f;              // fracción de la velocidad que se pierde por segundo
+        float gravity = 0.f;           // px/s²
+        sf::Color from = sf::Color::White; // color al nacer y al morir (el alfa también se funde)
+        sf::Color to = sf::Color::Transparent;
+    };
+
+    struct Stats {
+        std::size_t peak = 0;        // máximo de vivas desde el último resetStats()
+        std::uint64_t dropped = 0;   // partículas que no cupieron
+    };
+
+    explicit ParticleSystem(std::size_t capacity = DEFAULT_CAPACITY);
+
+    void emit(const Burst& burst, sf::Vector2f at);
+    void update(float dt);
+    void clear() { count_ = 0; }
+    // quads con mezcla aditiva: un draw para todas
+    void draw(sf::RenderTarget& target);
+
+    std::size_t size() const { return count_; }
+    std::size_t capacity() const { return capacity_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats{ count_, 0 }; }
+
+private:
+    std::size_t capacity_;
+    std::size_t count_ = 0;
+    // un array por campo, todos de tamaño capacity_
+    std::vector<float> x_, y_, vx_, vy_;
+    std::vector<float> age_;       // 0 al nacer, 1 al morir
+    std::vector<float> ageRate_;   // 1 / vida
+    std::vector<float> drag_;
+    std::vector<float> gravity_;
+    std::vector<float> size_;
+    std::vector<sf::Color> from_, to_;
+    std::vector<sf::Vertex> vertices_; // 6 por partícula
+    std::minstd_rand rng_;
+    Stats stats_;
+
+    void kill(std::size_t i);
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+// Percentil p (0..1) de [first, last) por rango más cercano: el elemento que quedaría en la
+// posición round(p · (n - 1)) si se ordenara. Usa nth_element, así que reordena el rango (se
+// puede llamar varias veces sobre el mismo); 0 si está vacío. Sin reservas: vale para el hilo
+// de simulación y para el de la ventana.
+template <typename It>
+typename std::iterator_traits<It>::value_type percentile(It first, It last, double p) {
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0) return {};
+    const std::size_t k = std::min(n - 1, static_cast<std::size_t>(p * static_cast<double>(n - 1) + 0.5));
+    const It nth = std::next(first, static_cast<std::ptrdiff_t>(k));
+    std::nth_element(first, nth, last);
+    return *nth;
+}
@@ -7,25 +7,37 @@
 
 class Player {
 public:
-    Player(const sf::Texture* texture, const sf::Vector2f& startPos);
+    Player(const sf::Vector2f& startPos, const sf::Vector2f& size);
     void setHorizontalLimits(float left, float right);
 
     void update(float dt);
-    void draw(sf::RenderWindow& window) const;
+    void savePrevious();
 
-    void moveLeft(float dt);
-    void moveRight(float dt);
+    void moveLeft(double dt);
+    void moveRight(double dt);
+    // segundos hasta que, moviéndose hacia ese lado, se pare en el borde (infinito si ya está)
+    float timeToEdge(bool right) const;
     void setPosition(const sf::Vector2f& pos);
+    // con la posición de antes del paso (la que usa el barrido de las colisiones)
+    void setPosition(const sf::Vector2f& pos, const sf::Vector2f& previous);
     sf::FloatRect bounds() const;
 
+    sf::Vector2f position() const { return position_; }
+    sf::Vector2f previousPosition() const { return prevPos_; }
+    float speed() const { return speed_; }
+
 private:
-    std::unique_ptr<sf::Sprite> sprite_;
-    sf::RectangleShape fallbackRect_;
+    static constexpr float LEFT_EDGE = 16.f;
+
     sf::Vector2f position_;
+    sf::Vector2f prevPos_;
+    // x acumulada en double: sumar cada paso en float deriva distinto según el paso (como Formation)
+    double x_;
+    sf::Vector2f half_;
     float speed_ = 150.f;
     float leftLimit_ = 16.f;
     float rightLimit_ = 800.f;
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AllocTracker.h"
+
+// Zonas de medición con ámbito. Con GALAGA_PROFILING=0 las macros no generan código.
+#ifndef GALAGA_PROFILING
+#define GALAGA_PROFILING 1
+#endif
+
+#define GALAGA_PROFILE_CONCAT2(a, b) a##b
+#define GALAGA_PROFILE_CONCAT(a, b) GALAGA_PROFILE_CONCAT2(a, b)
+
+#if GALAGA_PROFILING
+// cada punto de medición se registra una sola vez (static local) y luego solo usa su id
+#define PROFILE_ZONE(name) \
+    static const std::uint32_t GALAGA_PROFILE_CONCAT(profileSite_, __LINE__) = Profiler::instance().registerZone(name); \
+    ProfileZone GALAGA_PROFILE_CONCAT(profileZone_, __LINE__)(GALAGA_PROFILE_CONCAT(profileSite_, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+class Profiler {
+public:
+    struct ZoneSummary {
+        const char* name;
+        float p50Us;
+        float p99Us;
+        std::size_t samples;
+        std::uint64_t allocs; // reservas dentro de la zona (incluidas sus hijas) desde el principio; 0 sin GALAGA_ALLOC_TRACKING
+    };
+
+    static Profiler& instance();
+    static std::uint64_t nowNs();
+    // memoria residente del proceso en bytes (0 si la plataforma no la da)
+    static std::size_t residentBytes();
+
+    // apagado, las zonas no leen el reloj ni escriben nada (p. ej. runs en muchos hilos)
+    void setEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    std::uint32_t registerZone(const char* name);
+    // sin bloqueos: cada hilo escribe solo en su propio buffer
+    void record(std::uint32_t zone, std::uint64_t startNs, std::uint64_t durNs, std::uint64_t allocs = 0);
+    // reservas acumuladas de cada zona (todos los hilos), por id (out se reutiliza: no reserva si ya tiene sitio)
+    void allocsByZone(std::vector<std::uint64_t>& out) const;
+    const char* zoneName(std::uint32_t zone) const;
+
+    // percentiles de las últimas muestras de cada zona (juntando los hilos), en orden de primera aparición
+    std::vector<ZoneSummary> summarize() const;
+
+    // vuelca los eventos de los buffers circulares en formato trace_event de Chrome (chrome://tracing,
+    // Perfetto). Copia los buffers y escribe el fichero sin bloquear a los hilos que miden
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    Profiler();
+
+    static constexpr std::size_t THREAD_EVENT_CAPACITY = 1u << 14; // por hilo
+    static constexpr std::size_t ZONE_SAMPLES = 256;                // por zona y hilo
+    static constexpr std::size_t MAX_ZONES = 64;
+
+    // campos atómicos (relaxed) para que leerlos desde otro hilo mientras se escriben no sea una
+    // carrera; en x86 y ARM se quedan en loads y stores normales
+    struct Event {
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> dur{0};
+        std::atomic<std::uint64_t> zoneTid{0}; // zona en los 32 bits bajos, hilo en los altos
+    };
+    struct ZoneSamples {
+        std::array<std::atomic<float>, ZONE_SAMPLES> samples{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> allocs{0};
+    };
+    // lo escribe un único hilo a la vez (su dueño); los lectores copian sin pararlo.
+    // Un hilo que termina lo devuelve y lo hereda el siguiente que empiece a medir
+    struct ThreadBuffer {
+        std::array<Event, THREAD_EVENT_CAPACITY> events;
+        std::atomic<std::uint64_t> written{0};
+        std::array<ZoneSamples, MAX_ZONES> zones;
+        std::uint32_t tid = 0;
+        std::atomic<bool> inUse{false};
+    };
+    struct CopiedEvent {
+        std::uint32_t zone;
+        std::uint32_t tid;
+        std::uint64_t start;
+        std::uint64_t dur;
+    };
+
+    std::atomic<bool> enabled_{true};
+    // solo para registrar zonas e hilos y para los lectores; record() no lo toma
+    mutable std::mutex mutex_;
+    std::array<const char*, MAX_ZONES> zoneNames_{};
+    std::size_t zoneCount_ = 0;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::uint32_t threadCount_ = 0;
+
+    ThreadBuffer& threadBuffer();
+    ThreadBuffer* acquireBuffer();
+    void copyEvents(const ThreadBuffer& b, std::vector<CopiedEvent>& out) const;
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(std::uint32_t zone)
+    : zone_(zone), active_(Profiler::instance().enabled()), start_(active_ ? Profiler::nowNs() : 0)
+    , allocStart_(AllocTracker::enabled() && active_ ? AllocTracker::thisThread().allocs : 0) {}
+    ~ProfileZone() {
+        if (!active_) return;
+        const std::uint64_t allocs = AllocTracker::enabled() ? AllocTracker::thisThread().allocs - allocStart_ : 0;
+        Profiler::instance().record(zone_, start_, Profiler::nowNs() - start_, allocs);
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    std::uint32_t zone_;
+    bool active_;
+    std::uint64_t start_;
+    std::uint64_t allocStart_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Enemy.h"
+#include "Shield.h"
+
+// Copia de lo que se dibuja de un tick: posiciones (la anterior y la actual, para interpolar),
+// escudos y valores del HUD. El render lee de aquí mientras la simulación ya calcula el siguiente.
+// capture() reutiliza la memoria de la captura anterior y reserva de una vez para todas las
+// entidades de la simulación (vivas o no): tras la primera no reserva nada mientras no crezcan los pools.
+struct RenderSnapshot {
+    // solo las entidades vivas, en SoA como EntityArrays
+    struct Sprites {
+        std::vector<float> prevX, prevY, x, y;
+
+        std::size_t size() const { return x.size(); }
+        void clear() { prevX.clear(); prevY.clear(); x.clear(); y.clear(); }
+        void reserve(std::size_t n) { prevX.reserve(n); prevY.reserve(n); x.reserve(n); y.reserve(n); }
+        void push(float px, float py, float cx, float cy) {
+            prevX.push_back(px); prevY.push_back(py); x.push_back(cx); y.push_back(cy);
+        }
+    };
+
+    Sprites enemies;
+    std::vector<EnemyKind> enemyKinds;
+    Sprites playerBullets;
+    Sprites enemyBullets;
+    bool hasPlayer = false;
+    sf::Vector2f playerPrev;
+    sf::Vector2f player;
+
+    // se copian solo cuando cambia la revisión de la simulación
+    std::vector<Shield> shields;
+    std::uint32_t shieldRevision = 0;
+
+    int score = 0;
+    int lives = 0;
+    int wave = 0;
+    bool over = false;
+    std::uint64_t tick = 0;      // GameSim::tick()
+    std::uint64_t pairsTested = 0;
+
+    void capture(const class GameSim& sim);
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "GameSim.h"
+#include "InputActions.h"
+
+// Formato .grp (little-endian):
+//   ReplayHeader | entradas: 4 bits por tick, dos ticks por byte | checksums: uint32 por tick
+//   | acciones: ReplayAction en orden (solo las grabaciones con teclado; las herramientas no tienen)
+// Con la semilla, el paso y las entradas se re-simula la sesión entera; los checksums
+// grabados permiten localizar el primer tick en que la re-simulación se separa.
+constexpr char REPLAY_MAGIC[4] = { 'G', 'R', 'P', 'L' };
+// sube también cuando cambian las reglas de la simulación: una grabación vieja divergiría
+constexpr std::uint32_t REPLAY_VERSION = 7;
+
+struct ReplayHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t seed;
+    float dt;
+    std::uint64_t ticks;
+    std::uint32_t shieldShape; // GameSim::shieldShapeHash(): la forma de los escudos cambia la partida
+    std::uint32_t config;      // GameSim::configHash(): tamaño de la partida, pools, ritmos, cajas...
+    std::uint32_t actions;     // número de ReplayAction al final
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(ReplayHeader) == 40, "ReplayHeader debe ocupar 40 bytes");
+
+// una pulsación o suelta tal como la consumió la simulación
+struct ReplayAction {
+    std::uint32_t tick;    // tick en que se aplicó (antes de su step)
+    std::uint8_t subTick;  // posición dentro del intervalo del tick, 0..255
+    std::uint8_t action;   // Action
+    std::uint8_t pressed;
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(ReplayAction) == 8, "ReplayAction debe ocupar 8 bytes");
+
+// bits de cada tick
+enum ReplayBits : std::uint8_t {
+    REPLAY_LEFT = 1,
+    REPLAY_RIGHT = 2,
+    REPLAY_FIRE = 4,
+    REPLAY_RESET = 8 // reset() antes de este tick
+};
+
+// huella de 32 bits por tick (la de 64 plegada): basta para ver dónde diverge
+inline std::uint32_t foldChecksum(std::uint64_t h) { return static_cast<std::uint32_t>(h ^ (h >> 32)); }
+
+class ReplayRecorder {
+public:
+    void begin(std::uint32_t seed, float dt, std::uint32_t shieldShape, std::uint32_t config);
+    // llamar justo después de sim.step(input); resetBefore: hubo reset() desde el tick anterior
+    void record(const SimInput& input, bool resetBefore, const GameSim& sim);
+    // acción aplicada antes del próximo record()
+    void recordAction(Action action, bool pressed, std::uint8_t subTick);
+    bool save(const std::string& path) const;
+
+    std::uint64_t ticks() const { return checksums_.size(); }
+
+private:
+    std::uint32_t seed_ = 0;
+    float dt_ = 0.f;
+    std::uint32_t shieldShape_ = 0;
+    std::uint32_t config_ = 0;
+    std::vector<std::uint8_t> inputs_;
+    std::vector<std::uint32_t> checksums_;
+    std::vector<ReplayAction> actions_;
+};
+
+class Replay {
+public:
+    bool load(const std::string& path);
+
+    std::uint32_t seed() const { return seed_; }
+    float dt() const { return dt_; }
+    std::uint32_t shieldShape() const { return shieldShape_; }
+    std::uint32_t config() const { return config_; }
+    std::uint64_t ticks() const { return checksums_.size(); }
+
+    std::uint8_t bits(std::uint64_t tick) const { return (inputs_[tick / 2] >> ((tick % 2) * 4)) & 0xF; }
+    SimInput input(std::uint64_t tick) const;
+    std::uint32_t checksum(std::uint64_t tick) const { return checksums_[tick]; }
+    // vacío si la grabación no vino del teclado
+    const std::vector<ReplayAction>& actions() const { return actions_; }
+
+private:
+    std::uint32_t seed_ = 0;
+    float dt_ = 0.f;
+    std::uint32_t shieldShape_ = 0;
+    std::uint32_t config_ = 0;
+    std::vector<std::uint8_t> inputs_;
+    std::vector<std::uint32_t> checksums_;
+    std::vector<ReplayAction> actions_;
+};
+
+// Re-simula un Replay tick a tick sobre una GameSim creada con su semilla.
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay) : replay_(replay) {}
+
+    bool done() const { return tick_ >= replay_.ticks(); }
+    std::uint64_t tick() const { return tick_; }
+    bool resetPending() const { return !done() && (replay_.bits(tick_) & REPLAY_RESET); }
+
+    // un tick: reset si toca, step y comparación con el checksum grabado; false al acabar
+    bool step(GameSim& sim);
+    // igual, pero con la entrada que dé quien llama (p. ej. reconstruida desde las acciones)
+    bool step(GameSim& sim, const SimInput& input);
+
+    std::uint32_t lastChecksum() const { return lastChecksum_; }
+    std::optional<std::uint64_t> firstDivergence() const { return firstDivergence_; }
+    std::uint64_t divergentTicks() const { return divergent_; }
+
+private:
+    const Replay& replay_;
+    std::uint64_t tick_ = 0;
+    std::uint32_t lastChecksum_ = 0;
+    std::optional<std::uint64_t> firstDivergence_;
+    std::uint64_t divergent_ = 0;
+};
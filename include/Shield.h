@@ -1,22 +1,38 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <memory>
 #include <cstdint>
+#include <optional>
+#include "ShieldMask.h"
 
+// Escudo destructible píxel a píxel: la colisión y el daño van contra su máscara de ocupación.
 class Shield {
 public:
     Shield() = default;
-    Shield(const sf::Texture* tex, const sf::Vector2f& position, int hp = 3, const sf::Vector2f& size = {0.f,0.f});
+    Shield(const sf::Vector2f& position, const ShieldMask& mask);
+    // lo mismo sobre uno que ya existe: la máscara se copia encima, sin reservar
+    void reset(const sf::Vector2f& position, const ShieldMask& mask);
 
-    void draw(sf::RenderWindow& window) const;
     sf::FloatRect bounds() const;
-    bool takeDamage(int dmg = 1);
-    bool isActive() const;
+    bool isActive() const { return mask_.solidCount() > 0; }
+
+    // algún píxel sólido dentro de box (coordenadas de mundo)
+    bool overlaps(const sf::FloatRect& box) const;
+    // box desplazándose dy en vertical: fracción del desplazamiento (0..1) a la que toca el primer
+    // píxel sólido, o nada si lo atraviesa sin tocar (lo que overlaps() en cada extremo no ve)
+    std::optional<float> sweep(const sf::FloatRect& box, float dy) const;
+    // borra el cráter con centro en center; false si allí ya no quedaba nada
+    bool carve(const ShieldMask& crater, const sf::Vector2f& center);
+    // borra todo lo que cae dentro de box (un enemigo atravesándolo)
+    bool erase(const sf::FloatRect& box);
+
+    const ShieldMask& mask() const { return mask_; }
 
 private:
-    const sf::Texture* tex_ = nullptr;
-    std::unique_ptr<sf::Sprite> sprite_;
-    int hp_ = 0;
-    int maxHp_ = 0;
-    bool active_ = false;
-};
\ No newline at end of file
+    // px que una caja tiene que meterse en un píxel para tocarlo
+    static constexpr float TOUCH_SLACK = 0.01f;
+
+    sf::Vector2f position_;
+    ShieldMask mask_;
+
+    sf::IntRect toLocal(const sf::FloatRect& box) const;
+};
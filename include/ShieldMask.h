@@ -0,0 +1,55 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Ocupación de 1 bit por píxel, fila a fila en palabras de 64 bits (bit x de la fila y = píxel sólido).
+// Un escudo usa una a su tamaño en pantalla (120x60 = dos palabras por fila); los cráteres
+// son otra máscara pequeña que se borra con desplazamientos y AND de palabra entera.
+class ShieldMask {
+public:
+    ShieldMask() = default;
+    ShieldMask(int width, int height);
+
+    // alfa >= threshold de una imagen RGBA, muestreada (vecino más próximo) al tamaño pedido
+    static ShieldMask fromAlpha(const std::uint8_t* rgba, sf::Vector2u imageSize, sf::Vector2i size, std::uint8_t threshold = 128);
+    // lo mismo leyendo la imagen de disco (herramientas sin ventana: --shield assets/textures/shield.png)
+    static std::optional<ShieldMask> fromImageFile(const std::string& path, sf::Vector2i size);
+    // búnker clásico: esquinas superiores achaflanadas y arco abajo; sirve sin assets (headless)
+    static ShieldMask bunker(sf::Vector2i size);
+    // disco de bordes irregulares (siempre igual para el mismo radio); ancho <= 64
+    static ShieldMask crater(int radius);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int wordsPerRow() const { return wordsPerRow_; }
+    const std::uint64_t* row(int y) const { return bits_.data() + static_cast<std::size_t>(y) * wordsPerRow_; }
+    bool test(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1u; }
+    void set(int x, int y) { bits_[static_cast<std::size_t>(y) * wordsPerRow_ + (x >> 6)] |= std::uint64_t{1} << (x & 63); }
+    int solidCount() const { return solid_; }
+    std::size_t memoryBytes() const { return bits_.capacity() * sizeof(std::uint64_t); }
+
+    // rectángulo en píxeles locales, se recorta a la máscara
+    bool any(sf::IntRect rect) const { return firstSolidRow(rect, true) >= 0; }
+    // primera fila del rectángulo con algún píxel sólido, recorriéndolo hacia abajo o hacia arriba; -1 si no hay
+    int firstSolidRow(sf::IntRect rect, bool downwards) const;
+    // devuelve cuántos píxeles sólidos se borraron
+    int clear(sf::IntRect rect);
+    // borra stamp con su centro en (cx, cy); solo toca las filas del stamp
+    int carve(const ShieldMask& stamp, int cx, int cy);
+
+    // huella de los bits (para saber si dos sesiones usaron la misma forma)
+    std::uint32_t hash() const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int wordsPerRow_ = 0;
+    int solid_ = 0;
+    std::vector<std::uint64_t> bits_;
+
+    bool clip(sf::IntRect& rect) const;
+    void recount();
+};
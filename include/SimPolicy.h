@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string_view>
+#include "GameSim.h"
+
+// Quién "pulsa las teclas" en las ejecuciones sin ventana (headless, batch).
+enum class PolicyKind { Idle, Random, Bot, Script };
+
+class SimPolicy {
+public:
+    // script: solo con PolicyKind::Script; se repiten en bucle sus entradas (ni semilla ni resets)
+    explicit SimPolicy(PolicyKind kind = PolicyKind::Bot, std::uint32_t seed = 1, const class Replay* script = nullptr);
+
+    SimInput next(const GameSim& sim);
+
+    // "idle", "random", "bot", "script"
+    static std::optional<PolicyKind> parse(std::string_view name);
+
+private:
+    PolicyKind kind_;
+    std::mt19937 rng_;
+    std::bernoulli_distribution coin_{0.5};
+    const class Replay* script_;
+    std::uint64_t cursor_ = 0;
+};
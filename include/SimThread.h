@@ -0,0 +1,139 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "GameSim.h"
+#include "InputActions.h"
+#include "RenderSnapshot.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+// La partida en su propio hilo, a paso fijo contra el reloj (no contra los frames): un display()
+// bloqueado en el vsync o un frame lento ya no retrasan ni amontonan ticks.
+// Hacia dentro recibe órdenes en una cola (acciones con su marca de tiempo, correr/parar, reset);
+// hacia fuera publica tras cada tick un Frame (triple buffer) y los eventos de sonido y las
+// pulsaciones consumidas (colas). Ningún lado espera al otro.
+// Desde start() la GameSim, la grabación y el replay son del hilo; vuelven a ser accesibles tras stop().
+class SimThread {
+public:
+    // estabilidad del paso fijo, en ms: percentiles de los últimos STATS_WINDOW ticks,
+    // máximos de toda la sesión
+    struct TickStats {
+        float hz = 0.f;             // ticks por segundo medidos
+        float intervalP50 = 0.f;    // entre el comienzo de un tick y el del siguiente
+        float intervalP99 = 0.f;
+        float intervalMax = 0.f;
+        float lateP50 = 0.f;        // comienzo real menos el previsto
+        float lateP99 = 0.f;
+        float lateMax = 0.f;
+        std::uint64_t dropped = 0;  // ticks descartados por ir más de maxCatchUpTicks por detrás
+    };
+
+    struct Frame {
+        RenderSnapshot snapshot;
+        std::uint64_t tickNs = 0;         // límite del tick en actionClockNs() (para interpolar)
+        std::uint64_t ticks = 0;          // ticks desde start()
+        std::uint32_t commandSerial = 0;  // órdenes atendidas antes de publicar
+        bool halted = false;              // parado por fin de partida hasta el próximo reset
+        bool replaying = false;
+        TickStats stats;
+    };
+
+    // una pulsación real ya aplicada, para LatencyProbe
+    struct Press {
+        std::uint64_t inputNs = 0;
+        std::uint64_t tickNs = 0;  // cuándo la consumió el tick
+        std::uint64_t ticks = 0;   // Frame::ticks del primer Frame que la muestra
+    };
+
+    SimThread() = default;
+    ~SimThread();
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // recorder: ya con begin(); replay: se reproduce en vez de leer las acciones
+    void start(std::unique_ptr<GameSim> sim, float tickDt, int maxCatchUpTicks,
+               std::unique_ptr<class ReplayRecorder> recorder, std::unique_ptr<class Replay> replay);
+    void stop();
+    bool running() const { return thread_.joinable(); }
+
+    // --- hilo principal -> simulación, atendidas en orden. Devuelven el número de serie de la orden
+    std::uint32_t pushAction(const ActionEvent& ev);
+    // empieza a avanzar; heldMask: acciones de juego (1 << Action) pulsadas ahora mismo
+    std::uint32_t resume(std::uint32_t heldMask);
+    // deja de avanzar (menú, pausa) y descarta las acciones pendientes
+    std::uint32_t pause();
+    // partida nueva; durante un replay, además devuelve el control al teclado
+    std::uint32_t reset();
+    std::uint32_t commandsSent() const { return sent_; }
+
+    // --- simulación -> hilo principal
+    // el Frame más reciente (el mismo hasta que se publique otro)
+    const Frame& latest() { frames_.update(); return frames_.front(); }
+    // el que devolvió el último latest()
+    const Frame& current() const { return frames_.front(); }
+    bool pollEvent(SimEvent& out) { return events_.pop(out); }
+    bool pollPress(Press& out) { return presses_.pop(out); }
+    // eventos perdidos con la cola llena (solo sonidos: el estado va en el Frame)
+    std::uint64_t droppedEvents() const { return droppedEvents_.load(std::memory_order_relaxed); }
+
+    // tras stop()
+    class ReplayRecorder* recorder() { return running() ? nullptr : recorder_.get(); }
+
+private:
+    static constexpr std::size_t STATS_WINDOW = 512;
+    static constexpr std::uint64_t STATS_EVERY = 32;      // ticks entre recálculos de percentiles
+    static constexpr std::uint64_t IDLE_SLEEP_US = 1000;  // sondeo de órdenes mientras no avanza
+
+    struct Command {
+        enum class Kind : std::uint8_t { Action, Resume, Pause, Reset } kind = Kind::Action;
+        ActionEvent action{};
+        std::uint32_t heldMask = 0;
+    };
+
+    std::thread thread_;
+    std::atomic<bool> quit_{false};
+    SpscQueue<Command, 512> commands_;
+    std::uint32_t sent_ = 0; // solo lo toca el hilo principal
+    TripleBuffer<Frame> frames_;
+    SpscQueue<SimEvent, 1024> events_;
+    SpscQueue<Press, 256> presses_;
+    std::atomic<std::uint64_t> droppedEvents_{0};
+
+    // --- del hilo de simulación
+    std::unique_ptr<GameSim> sim_;
+    std::unique_ptr<class ReplayRecorder> recorder_;
+    std::unique_ptr<class Replay> replay_;
+    std::unique_ptr<class ReplayPlayer> replayPlayer_;
+    std::size_t replayActionCursor_ = 0;
+    float tickDt_ = 1.f / 120.f;
+    std::uint64_t tickNs_ = 0;
+    int maxCatchUpTicks_ = 8;
+    ActionRing ring_;
+    ActionState actionState_;
+    std::uint32_t processed_ = 0;
+    bool advancing_ = false;
+    bool halted_ = false;
+    // reset() solo si la partida ya avanzó: así cada tick grabado lleva como mucho un reset
+    bool simFresh_ = true;
+    bool resetBeforeStep_ = false;
+    std::uint64_t ticks_ = 0;
+    std::uint64_t lastTickNs_ = 0;   // límite del último tick
+    std::uint64_t lastStartNs_ = 0;  // cuándo empezó de verdad
+    std::array<float, STATS_WINDOW> intervalMs_{};
+    std::array<float, STATS_WINDOW> lateMs_{};
+    std::uint64_t samples_ = 0;
+    TickStats stats_;
+
+    std::uint32_t send(const Command& c);
+    void loop();
+    void drainCommands();
+    void runTick(std::uint64_t tickStartNs, std::uint64_t tickEndNs);
+    SimInput consumeActions(std::uint64_t tickStartNs, std::uint64_t tickEndNs);
+    SimInput replayActions();
+    void endReplay();
+    void measure(std::uint64_t startNs, std::uint64_t tickEndNs);
+    void publish();
+};
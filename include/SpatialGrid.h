@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Rejilla uniforme para la fase amplia de colisiones.
+// Se reconstruye con begin()/insert()/finish(); las celdas quedan en formato CSR
+// (un único array de ids ordenado por celda) para recorrerlas sin punteros.
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+    SpatialGrid(const sf::Vector2f& origin, float cellSize, int cols, int rows);
+
+    void begin(std::size_t maxId);
+    void insert(std::uint32_t id, const sf::FloatRect& box);
+    void finish();
+
+    // llama fn(id) una vez por cada candidato cuyas celdas se solapan con box
+    template <typename Fn>
+    void query(const sf::FloatRect& box, Fn&& fn) {
+        // descarte rápido contra la caja que envuelve todo lo insertado
+        if (box.position.x > occMax_.x || box.position.x + box.size.x < occMin_.x ||
+            box.position.y > occMax_.y || box.position.y + box.size.y < occMin_.y) return;
+        int c0, r0, c1, r1;
+        cellRange(box, c0, r0, c1, r1);
+        if (++stampId_ == 0) { std::fill(stamp_.begin(), stamp_.end(), 0u); stampId_ = 1; }
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const std::size_t cell = static_cast<std::size_t>(r * cols_ + c);
+                for (std::uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) {
+                    std::uint32_t id = items_[k];
+                    if (stamp_[id] == stampId_) continue;
+                    stamp_[id] = stampId_;
+                    fn(id);
+                }
+            }
+        }
+    }
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    std::size_t memoryBytes() const {
+        return entries_.capacity() * sizeof(Entry)
+             + (cellStart_.capacity() + items_.capacity() + stamp_.capacity() + scratch_.capacity()) * sizeof(std::uint32_t);
+    }
+
+private:
+    struct Entry { std::uint32_t cell; std::uint32_t id; };
+
+    sf::Vector2f origin_;
+    float invCell_ = 1.f;
+    int cols_ = 0;
+    int rows_ = 0;
+
+    sf::Vector2f occMin_;
+    sf::Vector2f occMax_;
+
+    std::vector<Entry> entries_;
+    std::vector<std::uint32_t> cellStart_;
+    std::vector<std::uint32_t> items_;
+    std::vector<std::uint32_t> stamp_;
+    std::vector<std::uint32_t> scratch_;
+    std::uint32_t stampId_ = 0;
+
+    void cellRange(const sf::FloatRect& box, int& c0, int& r0, int& c1, int& r1) const;
+};
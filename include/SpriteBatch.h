@@ -0,0 +1,35 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstddef>
+
+// Junta quads en un sf::VertexArray por textura y los envía con un único draw por textura.
+// Cada flush() respeta el orden en que aparecieron las texturas, así una capa
+// (escudos, enemigos, balas...) cuesta tantos draws como texturas distintas use.
+class SpriteBatch {
+public:
+    struct Stats {
+        std::size_t drawCalls = 0;
+        std::size_t vertices = 0;
+        std::size_t quads = 0;
+    };
+
+    // texture == nullptr dibuja un quad de color sólido
+    void add(const sf::Texture* texture, const sf::FloatRect& dest, const sf::FloatRect& texRect, const sf::Color& color = sf::Color::White);
+    void flush(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    // estadísticas acumuladas desde el último resetStats() (normalmente una vez por frame)
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats{}; }
+
+private:
+    struct Bucket {
+        const sf::Texture* texture = nullptr;
+        sf::VertexArray vertices{ sf::PrimitiveType::Triangles };
+    };
+    std::vector<Bucket> buckets_;
+    std::size_t used_ = 0;
+    Stats stats_;
+
+    Bucket& bucketFor(const sf::Texture* texture);
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Cola de un productor y un consumidor, de capacidad fija y sin bloqueos ni reservas.
+// push() solo desde el hilo productor, pop() solo desde el consumidor.
+template <typename T, std::size_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "la capacidad debe ser potencia de 2");
+
+public:
+    // false si está llena (el elemento no se encola)
+    bool push(const T& value) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) return false;
+        items_[head & (N - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = items_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    std::array<T, N> items_{};
+    // en líneas de caché distintas: cada hilo escribe solo la suya
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <optional>
+#include <string>
+
+// Panel de depuración: p50/p99 de cada zona del Profiler, contadores extra y gráfica de tiempos de frame.
+class StatsOverlay {
+public:
+    explicit StatsOverlay(const sf::Font* font);
+
+    void toggle() { visible_ = !visible_; }
+    bool visible() const { return visible_; }
+
+    void pushFrameTime(float seconds);
+
+    // devuelve true cuando toca regenerar el texto (unas pocas veces por segundo)
+    bool update(float dt);
+    void refresh(const std::string& counters);
+
+    void draw(sf::RenderTarget& target);
+
+private:
+    static constexpr std::size_t GRAPH_SAMPLES = 180;
+    static constexpr float GRAPH_HEIGHT = 60.f;
+    static constexpr float GRAPH_MAX_MS = 33.3f;
+
+    std::optional<sf::Text> text_;
+    sf::RectangleShape panel_;
+    sf::VertexArray graph_{ sf::PrimitiveType::LineStrip, GRAPH_SAMPLES };
+    sf::VertexArray budgetLine_{ sf::PrimitiveType::Lines, 2 };
+    std::array<float, GRAPH_SAMPLES> frameMs_{};
+    std::size_t frameHead_ = 0;
+    float refreshTimer_ = 0.f;
+    bool visible_ = false;
+};
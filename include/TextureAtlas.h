@@ -0,0 +1,46 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Empaqueta varias imágenes en una o más páginas de textura (estantes por altura).
+// Cada entrada se identifica por nombre y se dibuja con su sub-rectángulo.
+class TextureAtlas {
+public:
+    struct Region {
+        const sf::Texture* texture = nullptr;
+        sf::FloatRect rect;
+    };
+
+    TextureAtlas(unsigned int pageSize = 1024, unsigned int padding = 2);
+
+    // maxSize > 0 reduce la imagen (promediando) para que su lado mayor no pase de maxSize
+    void add(const std::string& name, const sf::Image& image, unsigned int maxSize = 0);
+    bool build();
+
+    Region region(const std::string& name) const;
+
+    // la misma reducción que add(), como función pura para hacerla fuera del hilo principal
+    static sf::Image shrinkToFit(const sf::Image& image, unsigned int maxSize);
+    std::size_t pageCount() const { return pages_.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        sf::Vector2u size;
+        std::vector<std::uint8_t> pixels; // RGBA, se libera tras build()
+        unsigned int page = 0;
+        sf::Vector2u pos;
+        bool placed = false;
+    };
+
+    unsigned int pageSize_;
+    unsigned int padding_;
+    std::vector<Entry> entries_;
+    std::vector<std::unique_ptr<sf::Texture>> pages_;
+
+    static std::vector<std::uint8_t> downscale(const sf::Image& image, sf::Vector2u dst);
+    static sf::Vector2u fitSize(sf::Vector2u src, unsigned int maxSize);
+};
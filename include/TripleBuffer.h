@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Último valor de un productor para un consumidor, sin bloqueos: tres copias que rotan.
+// El productor escribe en back() y publica; el consumidor toma la más reciente con update()
+// y la lee en front() hasta la siguiente. Ninguno espera al otro; si el consumidor va más
+// lento, las publicaciones intermedias se pierden (solo interesa la última).
+// back()/publish() solo desde el hilo productor, update()/front() solo desde el consumidor.
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return slots_[back_]; }
+    void publish() {
+        // la copia escrita pasa al medio (marcada como nueva) y la que había allí pasa a ser la de escribir
+        back_ = middle_.exchange(static_cast<std::uint8_t>(back_ | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // true si había una publicación nueva (y front() ya es ella)
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static constexpr std::uint8_t INDEX = 3;
+    static constexpr std::uint8_t FRESH = 4;
+
+    std::array<T, 3> slots_{};
+    // en líneas de caché distintas: cada hilo escribe solo su índice
+    alignas(64) std::uint8_t back_ = 0;
+    alignas(64) std::atomic<std::uint8_t> middle_{1};
+    alignas(64) std::uint8_t front_ = 2;
+};
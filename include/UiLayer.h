@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// Dónde cae un widget dentro de la ventana
+struct UiPlacement {
+    sf::Vector2f anchor{0.f, 0.f}; // fracción del tamaño de la ventana (0,0 arriba-izq, 1,1 abajo-der)
+    sf::Vector2f offset{0.f, 0.f}; // px desde el ancla
+    sf::Vector2f align{0.f, 0.f};  // punto del widget (fracción de sus límites locales) que se pone en el ancla
+};
+
+// Capa de UI retenida: los widgets guardan su estado y solo marcan la capa como sucia cuando cambian.
+// La capa recoloca y vuelve a rasterizar en un RenderTexture únicamente si algo cambió o cambió el
+// tamaño de la ventana; el resto de frames cuesta un único quad texturizado.
+// Se dibuja con la vista por defecto (1 unidad = 1 px).
+class UiLayer {
+public:
+    using Id = std::size_t;
+
+    Id addText(const sf::Font& font, const sf::String& str, unsigned int charSize, sf::Color color);
+    Id addRect(const sf::Vector2f& size, sf::Color fill, sf::Color outline = sf::Color::Transparent, float outlineThickness = 0.f);
+    Id addShape(const sf::ConvexShape& shape);
+    // rectángulo que cubre toda la ventana
+    Id addBackdrop(sf::Color fill);
+    // imagen escalada para cubrir la ventana, centrada
+    Id addCover(const sf::Texture& texture);
+
+    // los setters comparan con el valor actual y solo ensucian si cambia algo
+    void setString(Id id, const sf::String& str);
+    // texto ASCII (marcadores del HUD): se compone en un sf::String de la capa, sin reservar memoria
+    void setAscii(Id id, std::string_view str);
+    void setFillColor(Id id, sf::Color color);
+    void setVisible(Id id, bool visible);
+    void setSize(Id id, const sf::Vector2f& size); // solo rectángulos
+    void place(Id id, const UiPlacement& placement);
+
+    // límites globales del widget ya colocado (para hit-testing)
+    sf::FloatRect bounds(Id id);
+
+    void draw(sf::RenderTarget& target);
+
+    void clear() { widgets_.clear(); dirty_ = true; }
+    void markDirty() { dirty_ = true; }
+    std::uint64_t rasterCount() const { return rasterCount_; }
+
+private:
+    enum class Fit { None, Stretch, Cover };
+    struct Widget {
+        std::variant<sf::Text, sf::RectangleShape, sf::ConvexShape, sf::Sprite> item;
+        UiPlacement placement;
+        Fit fit = Fit::None;
+        sf::Color fill;
+        bool visible = true;
+    };
+
+    std::vector<Widget> widgets_;
+    sf::RenderTexture canvas_;
+    std::optional<sf::Sprite> canvasSprite_;
+    sf::Vector2u size_{0u, 0u};
+    bool dirty_ = true;
+    std::uint64_t rasterCount_ = 0;
+    sf::String scratch_; // conserva su capacidad entre llamadas a setAscii
+
+    Id push(Widget w);
+    void layout(Widget& w);
+    bool resize(sf::Vector2u size);
+};
@@ -3,6 +3,9 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
+#include "InputActions.h"
+#include "UiLayer.h"
 
 class Menu {
 public:
@@ -16,16 +19,18 @@ public:
     // establece textura de fondo (puede ser nullptr)
     void setBackground(const sf::Texture* tex);
 
-    // procesamiento de eventos (teclado/ratón)
-    void processEvent(const sf::Event& ev, sf::RenderWindow& window);
+    // procesamiento de eventos; el teclado llega ya traducido: bits (1 << Action) de las acciones
+    // pulsadas en este evento (MenuUp, MenuDown, Confirm; ver InputBindings). El ratón se lee con la
+    // vista por defecto, la de la capa
+    void processEvent(const sf::Event& ev, std::uint32_t pressedActions, sf::RenderWindow& window);
 
     // update por frame (dt en segundos)
     void update(float dt);
 
-    // dibuja el menú (fondo, items, indicador)
-    void draw(sf::RenderWindow& window) const;
+    // dibuja el menú (fondo, items, indicador); solo se re-rasteriza si cambió algo
+    void draw(sf::RenderWindow& window);
 
-    // cuando el usuario confirma (Enter o click), consumeConfirm devuelve true en el frame de la confirmación
+    // cuando el usuario confirma (Action::Confirm o click), consumeConfirm devuelve true en el frame de la confirmación
     bool consumeConfirm();
 
     int getSelectedIndex() const;
@@ -33,18 +38,21 @@ public:
 private:
     const sf::Font* font_;
     unsigned int charSize_;
-    std::vector<sf::Text> items_;
+    std::vector<UiLayer::Id> items_;
     std::vector<std::string> labels_;
     sf::Vector2f center_;
     float spacing_ = 64.f;
     int selected_ = 0;
 
-    // fondo opcional (gestión dinámica para evitar default ctor issues)
+    // fondo opcional
     const sf::Texture* bgTex_ = nullptr;
-    mutable std::unique_ptr<sf::Sprite> bgSprite_;
 
-    // indicador triangular
-    sf::ConvexShape pointer_;
+    // fondo, items e indicador viven en la capa retenida
+    UiLayer ui_;
+    UiLayer::Id pointer_ = 0;
+
+    // indicador triangular (plantilla; la copia dibujable está en ui_)
+    sf::ConvexShape pointerShape_;
     float pointerOffsetX_ = -48.f; // distancia relativa al borde izquierdo del texto
 
     // confirm flag
@@ -54,5 +62,6 @@ private:
     sf::Color colorNormal_ = sf::Color(140, 140, 140);
     sf::Color colorSelected_ = sf::Color(230, 230, 230);
 
+    void buildWidgets();
     void rebuild();
 };
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "Game.h"
+#include "AllocTracker.h"
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
 
-int main() {
+int main(int argc, char** argv) {
     const int WINDOW_COLS = 24;
     const int WINDOW_ROWS = 25;
     const int CELL_SIZE = 32;
@@ -11,7 +16,51 @@ int main() {
     unsigned int windowHeight = static_cast<unsigned int>(MARGIN.y + HUD_HEIGHT + WINDOW_ROWS * CELL_SIZE + MARGIN.y);
 
     Game game(windowWidth, windowHeight);
+    // tamaño de la partida: --cols, --rows, --player-bullets, --enemy-bullets, --fire-rate, --shoot-cooldown, --shields
+    SimConfig simConfig;
+    PacingMode pacing = PacingMode::Vsync;
+    float targetFps = 120.f;
+    int stressSteps = 0;
+    int stressFrames = 600;
+    std::string stressCsv;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tick-rate") game.setTickRate(std::strtof(argv[++i], nullptr));
+        else if (arg == "--max-catch-up") game.setMaxCatchUpTicks(std::atoi(argv[++i]));
+        else if (arg == "--record") game.setRecordPath(argv[++i]);
+        else if (arg == "--replay") game.setReplayPath(argv[++i]);
+        else if (arg == "--bindings") game.setBindingsPath(argv[++i]);
+        else if (arg == "--latency-log") game.setLatencyLogPath(argv[++i]);
+        else if (arg == "--target-fps") targetFps = std::strtof(argv[++i], nullptr);
+        else if (arg == "--pacing") {
+            // vsync | uncapped | limit (con --target-fps)
+            std::optional<PacingMode> mode = FramePacer::parse(argv[++i]);
+            if (mode) pacing = *mode;
+            else std::cerr << "[WARN] unknown pacing mode " << argv[i] << " (vsync, uncapped, limit)\n";
+        }
+        else if (arg == "--render-stall") game.setRenderStall(std::strtof(argv[++i], nullptr));
+        else if (arg == "--voices") game.setPolyphony(static_cast<std::size_t>(std::atoi(argv[++i])));
+        else if (arg == "--stress") stressSteps = std::atoi(argv[++i]);
+        else if (arg == "--stress-frames") stressFrames = std::atoi(argv[++i]);
+        else if (arg == "--stress-csv") stressCsv = argv[++i];
+        else if (applySimFlag(simConfig, arg, argv[i + 1])) ++i;
+    }
+    // sin valor: pueden ir los últimos
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--exit-after-replay") game.setExitAfterReplay(true);
+        if (arg != "--alloc-check") continue;
+        if (!AllocTracker::enabled()) {
+            std::cerr << "--alloc-check needs a build with GALAGA_ALLOC_TRACKING=ON\n";
+            return 1;
+        }
+        game.setAllocCheck(true);
+    }
+    game.setSimConfig(simConfig);
+    game.setPacing(pacing, targetFps);
+    if (stressSteps > 0) game.setStressSweep(stressSteps, stressFrames, stressCsv);
     if (!game.init()) return 1;
     game.run();
-    return 0;
-}
\ No newline at end of file
+    // 3, como galaga_headless --alloc-check: algún frame en régimen reservó memoria
+    return game.allocCheckPassed() ? 0 : 3;
+}
@@ -0,0 +1,109 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// sin constructor: se puede tocar desde operator new en cualquier momento de la vida del hilo
+thread_local AllocTracker::Counts threadCounts;
+std::atomic<std::uint64_t> totalAllocs{0};
+std::atomic<std::uint64_t> totalFrees{0};
+std::atomic<std::uint64_t> totalBytes{0};
+
+}
+
+AllocTracker::Counts AllocTracker::thisThread() {
+    return threadCounts;
+}
+
+AllocTracker::Counts AllocTracker::total() {
+    return Counts{ totalAllocs.load(std::memory_order_relaxed), totalFrees.load(std::memory_order_relaxed),
+                   totalBytes.load(std::memory_order_relaxed) };
+}
+
+#if GALAGA_ALLOC_TRACKING
+
+namespace {
+
+void countAlloc(std::size_t size) {
+    ++threadCounts.allocs;
+    threadCounts.bytes += size;
+    totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void countFree() {
+    ++threadCounts.frees;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size) {
+    countAlloc(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t align) {
+    countAlloc(size);
+    const auto a = static_cast<std::size_t>(align);
+#if defined(_WIN32)
+    return _aligned_malloc(size ? size : 1, a);
+#else
+    // aligned_alloc pide un tamaño múltiplo del alineamiento
+    return std::aligned_alloc(a, (size + a - 1) / a * a);
+#endif
+}
+
+void release(void* p) {
+    if (!p) return;
+    countFree();
+    std::free(p);
+}
+
+void releaseAligned(void* p) {
+    if (!p) return;
+    countFree();
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return allocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return allocateAligned(size, align); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+#endif
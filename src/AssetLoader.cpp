@@ -0,0 +1,97 @@
+#include "AssetLoader.h"
+#include "TextureAtlas.h"
+#include "AssetPack.h"
+#include "Profiler.h"
+#include <algorithm>
+
+AssetLoader::~AssetLoader() {
+    // si se sale antes de terminar, los hilos acaban el trabajo en curso y no cogen más
+    next_.store(jobs_.size(), std::memory_order_relaxed);
+    for (std::thread& t : workers_) t.join();
+}
+
+void AssetLoader::addImage(const std::string& name, const std::string& path, unsigned int maxSize) {
+    jobs_.push_back(Job{ name, path, Kind::Image, maxSize });
+}
+
+void AssetLoader::addSound(const std::string& name, const std::string& path) {
+    jobs_.push_back(Job{ name, path, Kind::Sound, 0 });
+}
+
+void AssetLoader::start(unsigned int threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency() - 1);
+    threads = std::min<unsigned int>(threads, static_cast<unsigned int>(jobs_.size()));
+    workers_.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i) workers_.emplace_back(&AssetLoader::work, this);
+}
+
+void AssetLoader::work() {
+    for (;;) {
+        const std::size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= jobs_.size()) return;
+        Result r = run(jobs_[i]);
+        {
+            std::lock_guard<std::mutex> lock(doneMutex_);
+            done_.push_back(std::move(r));
+        }
+        decoded_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+AssetLoader::Result AssetLoader::run(const Job& job) const {
+    PROFILE_ZONE("asset.decode");
+    Result r;
+    r.name = job.name;
+    r.path = job.path;
+    r.kind = job.kind;
+    const std::optional<AssetPack::View> packed = pack_ ? pack_->find(job.path) : std::nullopt;
+    const std::string loose = "assets/" + job.path;
+
+    if (job.kind == Kind::Image) {
+        sf::Image img;
+        if (packed && packed->kind == PackKind::Rgba) {
+            const sf::Vector2u size{ packed->param0, packed->param1 };
+            r.ok = packed->size == static_cast<std::size_t>(size.x) * size.y * 4;
+            if (r.ok) img = sf::Image(size, packed->data);
+        } else if (packed) {
+            r.ok = img.loadFromMemory(packed->data, packed->size);
+        } else {
+            r.ok = img.loadFromFile(loose);
+        }
+        if (r.ok) r.image = job.maxSize > 0 ? TextureAtlas::shrinkToFit(img, job.maxSize) : std::move(img);
+        return r;
+    }
+
+    SoundData& s = r.sound;
+    if (packed && packed->kind == PackKind::Pcm) {
+        // ya en PCM: se usa directamente la memoria mapeada
+        s.data = reinterpret_cast<const std::int16_t*>(packed->data);
+        s.count = packed->size / sizeof(std::int16_t);
+        s.channelCount = packed->param0;
+        s.sampleRate = packed->param1;
+        if (s.channelCount == 1) s.channelMap = { sf::SoundChannel::Mono };
+        else if (s.channelCount == 2) s.channelMap = { sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight };
+        r.ok = s.count > 0 && s.channelMap.size() == s.channelCount;
+        return r;
+    }
+    // audio comprimido: se decodifica entero a PCM 16 bits; el SoundBuffer se crea luego en el hilo principal
+    sf::InputSoundFile file;
+    if (packed ? !file.openFromMemory(packed->data, packed->size) : !file.openFromFile(loose)) return r;
+    s.channelCount = file.getChannelCount();
+    s.sampleRate = file.getSampleRate();
+    s.channelMap = file.getChannelMap();
+    s.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+    s.samples.resize(static_cast<std::size_t>(file.read(s.samples.data(), s.samples.size())));
+    s.data = s.samples.data();
+    s.count = s.samples.size();
+    r.ok = s.count > 0;
+    return r;
+}
+
+std::optional<AssetLoader::Result> AssetLoader::poll() {
+    std::lock_guard<std::mutex> lock(doneMutex_);
+    if (done_.empty()) return std::nullopt;
+    Result r = std::move(done_.front());
+    done_.pop_front();
+    return r;
+}
@@ -0,0 +1,109 @@
+#include "AssetPack.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+    file_ = file;
+    mapping_ = mapping;
+    base_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+    void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // el mapeo sigue vivo sin el descriptor
+    if (view == MAP_FAILED) return false;
+    // la música se lee en streaming de principio a fin; la lectura anticipada se pide abajo, solo
+    // para lo que la carga lee entero
+    madvise(view, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    base_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    // cabecera e índice: si algo no cuadra se descarta el paquete entero
+    PackHeader header{};
+    bool valid = size_ >= sizeof(PackHeader);
+    if (valid) {
+        std::memcpy(&header, base_, sizeof(header));
+        valid = std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 && header.version == PACK_VERSION &&
+                sizeof(PackHeader) + static_cast<std::size_t>(header.count) * sizeof(PackEntry) <= size_;
+    }
+    if (valid) {
+        entries_ = reinterpret_cast<const PackEntry*>(base_ + sizeof(PackHeader));
+        count_ = header.count;
+        for (std::uint32_t i = 0; i < count_ && valid; ++i) {
+            const PackEntry& e = entries_[i];
+            valid = e.offset <= size_ && e.size <= size_ - e.offset && std::memchr(e.name, '\0', sizeof(e.name)) != nullptr;
+        }
+    }
+    if (!valid) {
+        std::cerr << "[WARN] " << path << " is not a valid asset pack\n";
+        close();
+        return false;
+    }
+#ifndef _WIN32
+    // imágenes y efectos ya decodificados: la carga los copia enteros en cuanto arranca
+    const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    for (std::uint32_t i = 0; i < count_; ++i) {
+        const PackEntry& e = entries_[i];
+        if (e.kind == PackKind::Raw || e.size == 0) continue;
+        const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(base_ + e.offset) / page * page;
+        const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(base_ + e.offset + e.size);
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+    }
+#endif
+    return true;
+}
+
+void AssetPack::close() {
+    if (!base_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = mapping_ = nullptr;
+#else
+    munmap(const_cast<std::uint8_t*>(base_), size_);
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    entries_ = nullptr;
+    count_ = 0;
+}
+
+std::optional<AssetPack::View> AssetPack::find(std::string_view name) const {
+    // pocas decenas de entradas: búsqueda lineal
+    for (std::uint32_t i = 0; i < count_; ++i) {
+        const PackEntry& e = entries_[i];
+        if (name != e.name) continue;
+        return View{ base_ + e.offset, static_cast<std::size_t>(e.size), e.kind, e.param0, e.param1 };
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,119 @@
+#include "AudioMixer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AudioMixer::AudioMixer(std::size_t polyphony)
+: polyphony_(std::clamp<std::size_t>(polyphony, 1, MAX_VOICES))
+{
+    initialize(CHANNELS, SAMPLE_RATE, { sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight });
+}
+
+AudioMixer::~AudioMixer() {
+    // el hilo de audio llama a onGetData: hay que pararlo antes de destruir los miembros
+    stop();
+}
+
+std::optional<AudioMixer::ClipId> AudioMixer::addClip(const std::int16_t* samples, std::size_t count, unsigned int channels,
+                                                      unsigned int sampleRate, bool borrow) {
+    if (!samples || channels == 0 || sampleRate == 0 || count < channels) return std::nullopt;
+    if (clips_.size() > std::numeric_limits<ClipId>::max()) return std::nullopt;
+
+    Clip clip;
+    const std::size_t inFrames = count / channels;
+    if (borrow && channels == CHANNELS && sampleRate == SAMPLE_RATE) {
+        clip.data = samples;
+        clip.frames = inFrames;
+    } else {
+        // a estéreo (mono se duplica, más canales: los dos primeros) y a SAMPLE_RATE por interpolación lineal
+        const double step = static_cast<double>(sampleRate) / SAMPLE_RATE;
+        const std::size_t outFrames = std::max<std::size_t>(1, static_cast<std::size_t>(inFrames / step));
+        clip.owned.resize(outFrames * CHANNELS);
+        for (std::size_t f = 0; f < outFrames; ++f) {
+            const double srcPos = f * step;
+            const std::size_t i0 = std::min(static_cast<std::size_t>(srcPos), inFrames - 1);
+            const std::size_t i1 = std::min(i0 + 1, inFrames - 1);
+            const double t = srcPos - static_cast<double>(i0);
+            for (unsigned int c = 0; c < CHANNELS; ++c) {
+                const unsigned int src = std::min(c, channels - 1);
+                const double a = samples[i0 * channels + src];
+                const double b = samples[i1 * channels + src];
+                clip.owned[f * CHANNELS + c] = static_cast<std::int16_t>(std::lround(a + (b - a) * t));
+            }
+        }
+        clip.data = clip.owned.data();
+        clip.frames = outFrames;
+    }
+    clips_.push_back(std::move(clip));
+    return static_cast<ClipId>(clips_.size() - 1);
+}
+
+void AudioMixer::play(ClipId clip, std::uint8_t priority, float volume) {
+    if (clip >= clips_.size()) return;
+    const auto gain = static_cast<std::int32_t>(std::clamp(volume, 0.f, 1.f) * 32768.f);
+    if (!commands_.push(Command{ clip, priority, gain })) dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioMixer::Counters AudioMixer::totals() const {
+    return Counters{ played_.load(std::memory_order_relaxed), stolen_.load(std::memory_order_relaxed),
+                     dropped_.load(std::memory_order_relaxed) };
+}
+
+AudioMixer::Counters AudioMixer::takeFrame() {
+    const Counters now = totals();
+    const Counters frame{ now.played - lastFrame_.played, now.stolen - lastFrame_.stolen, now.dropped - lastFrame_.dropped,
+                          mixMaxNs_.exchange(0, std::memory_order_relaxed) };
+    lastFrame_ = now;
+    return frame;
+}
+
+// hilo de audio: voz libre o, si no hay, la menos prioritaria y más antigua que no supere a la nueva
+void AudioMixer::start(const Command& cmd) {
+    Voice* target = nullptr;
+    for (std::size_t i = 0; i < polyphony_; ++i) {
+        Voice& v = voices_[i];
+        if (!v.active) { target = &v; break; }
+        if (v.priority > cmd.priority) continue;
+        if (!target || v.priority < target->priority || (v.priority == target->priority && v.serial < target->serial)) target = &v;
+    }
+    if (!target) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (target->active) stolen_.fetch_add(1, std::memory_order_relaxed);
+    *target = Voice{ true, cmd.clip, cmd.priority, cmd.gain, 0, nextSerial_++ };
+    played_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AudioMixer::onGetData(Chunk& data) {
+    // nada que pueda bloquear en este hilo (ni el profiler): el reloj y un máximo atómico
+    const std::uint64_t startNs = Profiler::nowNs();
+    Command cmd;
+    while (commands_.pop(cmd)) start(cmd);
+
+    accum_.fill(0);
+    std::size_t active = 0;
+    for (std::size_t i = 0; i < polyphony_; ++i) {
+        Voice& v = voices_[i];
+        if (!v.active) continue;
+        const Clip& clip = clips_[v.clip];
+        const std::size_t frames = std::min(CHUNK_FRAMES, clip.frames - v.pos);
+        const std::int16_t* src = clip.data + v.pos * CHANNELS;
+        for (std::size_t s = 0; s < frames * CHANNELS; ++s) accum_[s] += (src[s] * v.gain) >> 15;
+        v.pos += frames;
+        if (v.pos >= clip.frames) v.active = false;
+        else ++active;
+    }
+    for (std::size_t s = 0; s < out_.size(); ++s)
+        out_[s] = static_cast<std::int16_t>(std::clamp<std::int32_t>(accum_[s], -32768, 32767));
+    active_.store(active, std::memory_order_relaxed);
+    const std::uint64_t mixNs = Profiler::nowNs() - startNs;
+    std::uint64_t worst = mixMaxNs_.load(std::memory_order_relaxed);
+    while (mixNs > worst && !mixMaxNs_.compare_exchange_weak(worst, mixNs, std::memory_order_relaxed)) {}
+
+    // siempre hay datos (silencio si no suena nada): el stream no termina nunca
+    data.samples = out_.data();
+    data.sampleCount = out_.size();
+    return true;
+}
@@ -0,0 +1,101 @@
+#include "BulletPool.h"
+#include <algorithm>
+
+BulletPool::BulletPool(std::size_t capacity, const sf::Vector2f& size, std::size_t hardLimit)
+: hardLimit_(std::max(hardLimit, capacity)) {
+    data_.half = size / 2.f;
+    data_.reserve(capacity);
+    generation_.reserve(capacity);
+    originY_.reserve(capacity);
+    flight_.reserve(capacity);
+    denseIndex_.reserve(capacity);
+    freeList_.reserve(capacity);
+    active_.reserve(capacity);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        data_.push(0.f, 0.f, false);
+        generation_.push_back(0);
+        originY_.push_back(0.f);
+        flight_.push_back(0.0);
+        denseIndex_.push_back(UINT32_MAX);
+    }
+    // al revés para que el primer acquire devuelva el hueco 0
+    for (std::size_t i = capacity; i-- > 0;) freeList_.push_back(static_cast<std::uint32_t>(i));
+    stats_.capacity = capacity;
+}
+
+bool BulletPool::grow() {
+    const std::size_t cap = data_.size();
+    if (cap >= hardLimit_) return false;
+    const std::size_t newCap = std::min(hardLimit_, std::max<std::size_t>(cap * 2, 16));
+    data_.reserve(newCap);
+    for (std::size_t i = cap; i < newCap; ++i) {
+        data_.push(0.f, 0.f, false);
+        generation_.push_back(0);
+        originY_.push_back(0.f);
+        flight_.push_back(0.0);
+        denseIndex_.push_back(UINT32_MAX);
+    }
+    for (std::size_t i = newCap; i-- > cap;) freeList_.push_back(static_cast<std::uint32_t>(i));
+    stats_.capacity = newCap;
+    return true;
+}
+
+BulletHandle BulletPool::acquire(const sf::Vector2f& pos, float speedY, float flown) {
+    if (freeList_.empty() && !grow()) {
+        ++stats_.failedAcquires;
+        return BulletHandle{};
+    }
+    const std::uint32_t i = freeList_.back();
+    freeList_.pop_back();
+
+    data_.alive[i] = 1;
+    data_.x[i] = data_.prevX[i] = pos.x;
+    data_.prevY[i] = pos.y;
+    data_.y[i] = pos.y + speedY * flown;
+    originY_[i] = pos.y;
+    flight_[i] = flown;
+    data_.vx[i] = 0.f;
+    data_.vy[i] = speedY;
+
+    denseIndex_[i] = static_cast<std::uint32_t>(active_.size());
+    active_.push_back(i);
+    stats_.highWater = std::max(stats_.highWater, active_.size());
+    return BulletHandle{ i, generation_[i] };
+}
+
+void BulletPool::release(std::uint32_t index) {
+    if (!data_.alive[index]) return;
+    data_.alive[index] = 0;
+    ++generation_[index];
+
+    const std::uint32_t pos = denseIndex_[index];
+    const std::uint32_t last = active_.back();
+    active_[pos] = last;
+    denseIndex_[last] = pos;
+    active_.pop_back();
+    denseIndex_[index] = UINT32_MAX;
+    freeList_.push_back(index);
+}
+
+void BulletPool::clear() {
+    for (std::size_t k = active_.size(); k-- > 0;) release(active_[k]);
+}
+
+void BulletPool::update(double dt) {
+    float* y = data_.y.data();
+    const float* vy = data_.vy.data();
+    const float h = data_.half.y;
+    for (std::size_t k = active_.size(); k-- > 0;) {
+        const std::uint32_t i = active_[k];
+        flight_[i] += dt;
+        y[i] = static_cast<float>(originY_[i] + vy[i] * flight_[i]);
+        if (y[i] + h < -200.f || y[i] - h > 5000.f) release(i);
+    }
+}
+
+void BulletPool::savePrevious() {
+    for (std::uint32_t i : active_) {
+        data_.prevX[i] = data_.x[i];
+        data_.prevY[i] = data_.y[i];
+    }
+}
@@ -0,0 +1,215 @@
+#include "EntityRenderer.h"
+#include "GameSim.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iostream>
+
+EntityRenderer::EntityRenderer() {
+    visual(EntityKind::PlayerBullet).fallbackColor = sf::Color::Yellow;
+    visual(EntityKind::EnemyBullet).fallbackColor = sf::Color::Yellow;
+    visual(EntityKind::AlienTop).fallbackColor = sf::Color(200,80,80);
+    visual(EntityKind::AlienMid).fallbackColor = sf::Color(200,80,80);
+    visual(EntityKind::AlienBottom).fallbackColor = sf::Color(200,80,80);
+}
+
+void EntityRenderer::configure(const SimConfig& config) {
+    visual(EntityKind::Player).hitSize = config.playerSize;
+    visual(EntityKind::PlayerBullet).hitSize = config.playerBulletSize;
+    visual(EntityKind::EnemyBullet).hitSize = config.enemyBulletSize;
+    visual(EntityKind::AlienTop).hitSize = config.enemySize;
+    visual(EntityKind::AlienMid).hitSize = config.enemySize;
+    visual(EntityKind::AlienBottom).hitSize = config.enemySize;
+    for (auto &v : kinds_) rebuild(v);
+
+    // mismo redondeo que GameSim al crear las máscaras; con el mismo tamaño se conserva la imagen
+    const sf::Vector2i pixels{ static_cast<int>(std::lround(config.shieldSize.x)), static_cast<int>(std::lround(config.shieldSize.y)) };
+    if (pixels != shieldPixels_ || shieldBase_.empty()) {
+        shieldPixels_ = pixels;
+        shieldBase_.assign(static_cast<std::size_t>(shieldPixels_.x) * shieldPixels_.y * 4, 255);
+    }
+    shieldShown_.clear();
+
+    staticSprite_.reset();
+    if (staticLayer_.resize({ config.virtualWidth(), config.virtualHeight() })) {
+        staticSprite_.emplace(staticLayer_.getTexture());
+    } else {
+        std::cerr << "[WARN] EntityRenderer: could not create static layer, drawing shields every frame\n";
+    }
+    staticDirty_ = true;
+}
+
+void EntityRenderer::setShieldImage(const sf::Image& img) {
+    const sf::Vector2u size = img.getSize();
+    const std::uint8_t* src = img.getPixelsPtr();
+    if (!src || size.x == 0 || size.y == 0 || shieldPixels_.x <= 0) return;
+    // vecino más próximo, igual que ShieldMask::fromAlpha: cada píxel sólido tiene su color
+    for (int y = 0; y < shieldPixels_.y; ++y) {
+        const std::size_t sy = static_cast<std::size_t>(y) * size.y / shieldPixels_.y;
+        for (int x = 0; x < shieldPixels_.x; ++x) {
+            const std::size_t sx = static_cast<std::size_t>(x) * size.x / shieldPixels_.x;
+            std::copy_n(src + (sy * size.x + sx) * 4, 4, shieldBase_.data() + (static_cast<std::size_t>(y) * shieldPixels_.x + x) * 4);
+        }
+    }
+    shieldShown_.clear(); // se vuelve a subir todo
+}
+
+void EntityRenderer::setTexture(EntityKind kind, const sf::Texture* tex) {
+    if (tex && tex->getSize().x) setRegion(kind, tex, sf::FloatRect({ 0.f, 0.f }, sf::Vector2f(tex->getSize())));
+    else setRegion(kind, nullptr, {});
+}
+
+void EntityRenderer::setRegion(EntityKind kind, const sf::Texture* tex, const sf::FloatRect& rect) {
+    KindVisual& v = visual(kind);
+    v.texture = (tex && rect.size.x > 0.f && rect.size.y > 0.f) ? tex : nullptr;
+    v.texRect = rect;
+    rebuild(v);
+
+    singleTexture_ = kinds_[0].texture != nullptr;
+    for (const auto &k : kinds_) singleTexture_ = singleTexture_ && k.texture == kinds_[0].texture;
+}
+
+void EntityRenderer::rebuild(KindVisual& v) {
+    v.drawSize = v.hitSize;
+    if (!v.texture) return;
+
+    const sf::Vector2f ts = v.texRect.size;
+    if (!v.stretch) {
+        float scale = std::min(v.hitSize.x / ts.x, v.hitSize.y / ts.y);
+        v.drawSize = ts * scale;
+    }
+}
+
+void EntityRenderer::addQuad(const KindVisual& v, const sf::Vector2f& center, const sf::Color& tint) {
+    sf::FloatRect dest(center - v.drawSize / 2.f, v.drawSize);
+    if (v.texture) batch_.add(v.texture, dest, v.texRect, tint);
+    else batch_.add(nullptr, dest, {}, v.fallbackColor);
+}
+
+void EntityRenderer::addSprites(const KindVisual& v, const RenderSnapshot::Sprites& sprites, float alpha) {
+    for (std::size_t i = 0; i < sprites.size(); ++i) {
+        sf::Vector2f pos{ sprites.prevX[i] + (sprites.x[i] - sprites.prevX[i]) * alpha,
+                          sprites.prevY[i] + (sprites.y[i] - sprites.prevY[i]) * alpha };
+        addQuad(v, pos);
+    }
+}
+
+// sube a la textura los píxeles de mask dentro de rect (coordenadas del escudo)
+void EntityRenderer::uploadShield(std::size_t index, const ShieldMask& mask, const sf::IntRect& rect) {
+    shieldScratch_.resize(static_cast<std::size_t>(rect.size.x) * rect.size.y * 4);
+    std::uint8_t* out = shieldScratch_.data();
+    for (int y = rect.position.y; y < rect.position.y + rect.size.y; ++y) {
+        for (int x = rect.position.x; x < rect.position.x + rect.size.x; ++x, out += 4) {
+            if (mask.test(x, y)) std::copy_n(shieldBase_.data() + (static_cast<std::size_t>(y) * shieldPixels_.x + x) * 4, 4, out);
+            else std::fill_n(out, 4, std::uint8_t{0});
+        }
+    }
+    const sf::Vector2u dest{ static_cast<unsigned int>(rect.position.x),
+                             static_cast<unsigned int>(rect.position.y + static_cast<int>(index) * shieldPixels_.y) };
+    shieldTexture_.update(shieldScratch_.data(), sf::Vector2u(rect.size), dest);
+    shieldTexelsUploaded_ += static_cast<std::uint64_t>(rect.size.x) * rect.size.y;
+    staticDirty_ = true;
+}
+
+// compara por XOR de palabras las máscaras de la captura con las ya subidas
+// y sube solo el rectángulo que las contiene
+void EntityRenderer::syncShields(const RenderSnapshot& snap) {
+    const std::vector<Shield>& shields = snap.shields;
+    if (shieldShown_.size() == shields.size() && shieldRevision_ == snap.shieldRevision) return;
+    shieldRevision_ = snap.shieldRevision;
+
+    const sf::Vector2u texSize{ static_cast<unsigned int>(shieldPixels_.x), static_cast<unsigned int>(shieldPixels_.y) * static_cast<unsigned int>(shields.size()) };
+    if (shieldShown_.size() != shields.size()) {
+        if (texSize.y == 0) { shieldShown_.clear(); return; }
+        shieldTextureOk_ = shieldTexture_.getSize() == texSize || shieldTexture_.resize(texSize);
+        if (!shieldTextureOk_) { std::cerr << "[WARN] EntityRenderer: could not create shield texture\n"; return; }
+        shieldShown_.clear();
+        for (std::size_t i = 0; i < shields.size(); ++i) {
+            const ShieldMask& mask = shields[i].mask();
+            uploadShield(i, mask, sf::IntRect({ 0, 0 }, { mask.width(), mask.height() }));
+            shieldShown_.push_back(mask);
+        }
+        return;
+    }
+    if (!shieldTextureOk_) return;
+    for (std::size_t i = 0; i < shields.size(); ++i) {
+        const ShieldMask& now = shields[i].mask();
+        ShieldMask& shown = shieldShown_[i];
+        int x0 = now.width(), x1 = -1, y0 = now.height(), y1 = -1;
+        for (int y = 0; y < now.height(); ++y) {
+            const std::uint64_t* a = now.row(y);
+            const std::uint64_t* b = shown.row(y);
+            for (int w = 0; w < now.wordsPerRow(); ++w) {
+                const std::uint64_t diff = a[w] ^ b[w];
+                if (!diff) continue;
+                y0 = std::min(y0, y);
+                y1 = y;
+                x0 = std::min(x0, w * 64 + std::countr_zero(diff));
+                x1 = std::max(x1, w * 64 + 63 - std::countl_zero(diff));
+            }
+        }
+        if (y1 < 0) continue;
+        uploadShield(i, now, sf::IntRect({ x0, y0 }, { x1 - x0 + 1, y1 - y0 + 1 }));
+        shown = now;
+    }
+}
+
+void EntityRenderer::addShields(const RenderSnapshot& snap) {
+    if (!shieldTextureOk_) return;
+    const std::vector<Shield>& shields = snap.shields;
+    const sf::Vector2f size{ static_cast<float>(shieldPixels_.x), static_cast<float>(shieldPixels_.y) };
+    for (std::size_t i = 0; i < shields.size(); ++i) {
+        if (!shields[i].isActive()) continue;
+        const sf::FloatRect texRect({ 0.f, size.y * static_cast<float>(i) }, size);
+        batch_.add(&shieldTexture_, sf::FloatRect(shields[i].bounds().position, size), texRect);
+    }
+}
+
+// false si no hay capa estática y los escudos se deben dibujar con el resto
+bool EntityRenderer::drawStatic(sf::RenderTarget& target, const RenderSnapshot& snap) {
+    if (!staticSprite_) return false;
+    if (staticDirty_ || staticRevision_ != snap.shieldRevision) {
+        staticLayer_.clear(backgroundColor_);
+        addShields(snap);
+        batch_.flush(staticLayer_);
+        staticLayer_.display();
+        staticRevision_ = snap.shieldRevision;
+        staticDirty_ = false;
+        ++staticRebuilds_;
+    }
+    // la capa es opaca: se copia sin mezclar
+    target.draw(*staticSprite_, sf::RenderStates(sf::BlendNone));
+    return true;
+}
+
+void EntityRenderer::draw(sf::RenderTarget& target, const RenderSnapshot& snap, float alpha) {
+    batch_.resetStats();
+    // con varias texturas hay que vaciar el lote entre capas para respetar el orden;
+    // con una sola página el orden de inserción ya es el orden de dibujo
+    auto endLayer = [&]() { if (!singleTexture_) batch_.flush(target); };
+
+    // textura propia: siempre es una capa aparte (la estática, o un lote si no se pudo crear)
+    syncShields(snap);
+    if (!drawStatic(target, snap)) {
+        addShields(snap);
+        batch_.flush(target);
+    }
+
+    const RenderSnapshot::Sprites& en = snap.enemies;
+    for (std::size_t i = 0; i < en.size(); ++i) {
+        EntityKind kind = EntityKind::AlienMid;
+        if (snap.enemyKinds[i] == EnemyKind::Top) kind = EntityKind::AlienTop;
+        else if (snap.enemyKinds[i] == EnemyKind::Bottom) kind = EntityKind::AlienBottom;
+        sf::Vector2f pos{ en.prevX[i] + (en.x[i] - en.prevX[i]) * alpha,
+                          en.prevY[i] + (en.y[i] - en.prevY[i]) * alpha };
+        addQuad(visual(kind), pos);
+    }
+    endLayer();
+
+    addSprites(visual(EntityKind::PlayerBullet), snap.playerBullets, alpha);
+    addSprites(visual(EntityKind::EnemyBullet), snap.enemyBullets, alpha);
+    endLayer();
+
+    if (snap.hasPlayer) addQuad(visual(EntityKind::Player), snap.playerPrev + (snap.player - snap.playerPrev) * alpha);
+    batch_.flush(target);
+}
@@ -1,19 +1,50 @@
 #include "Formation.h"
+#include "Profiler.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
 
-Formation::Formation(const sf::Texture* topTex,
-                     const sf::Texture* midTex,
-                     const sf::Texture* botTex,
-                     int cols, int rows,
+namespace {
+
+void setBit(std::vector<std::uint64_t>& words, std::size_t i) { words[i >> 6] |= std::uint64_t{1} << (i & 63); }
+void clearBit(std::vector<std::uint64_t>& words, std::size_t i) { words[i >> 6] &= ~(std::uint64_t{1} << (i & 63)); }
+
+int firstSet(const std::vector<std::uint64_t>& words) {
+    for (std::size_t w = 0; w < words.size(); ++w)
+        if (words[w]) return static_cast<int>(w * 64 + std::countr_zero(words[w]));
+    return -1;
+}
+
+int lastSet(const std::vector<std::uint64_t>& words) {
+    for (std::size_t w = words.size(); w-- > 0;)
+        if (words[w]) return static_cast<int>(w * 64 + 63 - std::countl_zero(words[w]));
+    return -1;
+}
+
+}
+
+Formation::Formation(int cols, int rows,
                      const sf::Vector2f& startPos,
                      float spacingX, float spacingY,
-                     float speed, float dropAmount)
-: topTex_(topTex), midTex_(midTex), botTex_(botTex),
-  cols_(cols), rows_(rows), startPos_(startPos),
+                     const sf::Vector2f& enemySize,
+                     float speed, float dropAmount, float bounceSpeedup)
+: cols_(cols), rows_(rows), startPos_(startPos),
   spacingX_(spacingX), spacingY_(spacingY),
-  speed_(speed), dropAmount_(dropAmount)
+  speed_(speed), dropAmount_(dropAmount), bounceSpeedup_(bounceSpeedup)
 {
+    enemies_.half = enemySize / 2.f;
+    build();
+}
+
+void Formation::build() {
+    offsetX_ = 0.0;
+    offsetY_ = 0.0;
     enemies_.clear();
+    kinds_.clear();
+    const std::size_t total = static_cast<std::size_t>(std::max(0, cols_ * rows_));
+    enemies_.reserve(total);
+    kinds_.reserve(total);
 
     int topCount = 1;
     int midCount = 0;
@@ -24,109 +55,176 @@ Formation::Formation(const sf::Texture* topTex,
     if (botCount < 0) { botCount = 0; midCount = rows_ - topCount; }
 
     for (int r = 0; r < rows_; ++r) {
-        const sf::Texture* tex = midTex_;
+        EnemyKind kind = EnemyKind::Mid;
         if (r < topCount) {
-            tex = topTex_;
+            kind = EnemyKind::Top;
         } else if (r < topCount + midCount) {
-            tex = midTex_;
+            kind = EnemyKind::Mid;
         } else {
-            tex = botTex_;
+            kind = EnemyKind::Bottom;
         }
 
         for (int c = 0; c < cols_; ++c) {
-            sf::Vector2f pos{ startPos_.x + c * spacingX_, startPos_.y + r * spacingY_ };
-            enemies_.emplace_back(tex, pos);
+            enemies_.push(startPos_.x + c * spacingX_, startPos_.y + r * spacingY_);
+            kinds_.push_back(kind);
+        }
+    }
+
+    occupancy_.assign((total + 63) / 64, 0);
+    for (std::size_t i = 0; i < total; ++i) setBit(occupancy_, i);
+    const std::size_t ncols = static_cast<std::size_t>(std::max(0, cols_));
+    liveCols_.assign((ncols + 63) / 64, 0);
+    colCount_.assign(ncols, rows_);
+    colBottom_.assign(ncols, -1);
+    if (rows_ > 0) {
+        for (std::size_t c = 0; c < ncols; ++c) {
+            setBit(liveCols_, c);
+            colBottom_[c] = (rows_ - 1) * cols_ + static_cast<int>(c);
         }
     }
     computeBounds();
 }
 
-void Formation::computeBounds() {
-    bool first = true;
-    float minx = 0.f, maxx = 0.f;
-    for (const auto &e : enemies_) {
-        if (!e.isActive()) continue;
-        auto b = e.bounds();
-        if (first) {
-            minx = b.position.x;
-            maxx = b.position.x + b.size.x;
-            first = false;
-        } else {
-            minx = std::min(minx, b.position.x);
-            maxx = std::max(maxx, b.position.x + b.size.x);
-        }
+void Formation::kill(std::size_t i) {
+    if (!enemies_.alive[i]) return;
+    enemies_.alive[i] = 0;
+    clearBit(occupancy_, i);
+
+    const int c = static_cast<int>(i) % cols_;
+    const std::size_t col = static_cast<std::size_t>(c);
+    if (--colCount_[col] == 0) {
+        clearBit(liveCols_, col);
+        colBottom_[col] = -1;
+    } else if (colBottom_[col] == static_cast<int>(i)) {
+        // sube por la columna hasta el siguiente vivo
+        int idx = static_cast<int>(i) - cols_;
+        while (idx >= 0 && !enemies_.alive[static_cast<std::size_t>(idx)]) idx -= cols_;
+        colBottom_[col] = idx;
     }
-    if (first) {
+}
+
+void Formation::computeBounds() {
+    // todos los enemigos de una columna comparten x (los muertos también se mueven),
+    // así que basta con la x de la fila 0 de las columnas vivas de los extremos
+    const int left = firstSet(liveCols_);
+    if (left < 0) {
         minX_ = maxX_ = 0.f;
-    } else {
-        minX_ = minx;
-        maxX_ = maxx;
+        return;
     }
+    const int right = lastSet(liveCols_);
+    minX_ = enemies_.x[static_cast<std::size_t>(left)] - enemies_.half.x;
+    maxX_ = enemies_.x[static_cast<std::size_t>(right)] + enemies_.half.x;
 }
 
-void Formation::update(float dt, float screenLeft, float screenRight) {
-    if (enemies_.empty()) return;
-
-    float moveX = dir_ * speed_ * dt;
-    for (auto &e : enemies_) {
-        if (e.isActive()) e.moveBy({ moveX, 0.f });
-    }
+void Formation::update(double dt, float screenLeft, float screenRight) {
+    PROFILE_ZONE("Formation::update");
+    const std::size_t n = enemies_.size();
+    if (n == 0) return;
 
+    const double moveX = dir_ * speed_ * dt;
+    offsetX_ += moveX;
+    place();
     computeBounds();
 
-    if (minX_ < screenLeft || maxX_ > screenRight) {
-        for (auto &e : enemies_) {
-            if (e.isActive()) e.moveBy({ -moveX, 0.f });
-        }
-        // invertir y aplicar drop
-        dir_ *= -1;
-        for (auto &e : enemies_) {
-            if (e.isActive()) e.moveBy({ 0.f, dropAmount_ });
-        }
-        // aumentar velocidad
-        speed_ *= 1.07f;
-        computeBounds();
+    // el margen deja sin rebotar a quien solo toca el borde por redondeo: de ese rebote se
+    // encarga bounceAtEdge entre dos trozos del tick
+    if (minX_ < screenLeft - EDGE_SLACK || maxX_ > screenRight + EDGE_SLACK) {
+        // rebota en el borde: lo que se pasó lo recorre de vuelta ya a la velocidad nueva, así la
+        // trayectoria no depende del paso (antes se quedaba parada el tick del rebote)
+        const double limit = std::abs(moveX);
+        const double over = std::clamp(static_cast<double>(minX_ < screenLeft ? minX_ - screenLeft : maxX_ - screenRight), -limit, limit);
+        offsetX_ -= over * (1.0 + bounceSpeedup_);
+        bounce();
     }
 }
 
-void Formation::draw(sf::RenderWindow& window) const {
-    for (const auto &e : enemies_) {
-        if (e.isActive()) e.draw(window);
-    }
+// px que le quedan al frente (la columna viva del extremo hacia el que va) hasta el borde;
+// como computeBounds, pero con las columnas vivas de ahora (puede haber caído una desde update)
+// y en double, con la misma cuenta que place: con las x en float el corte del tick caería un
+// redondeo antes o después del borde, y el error seguiría ahí tras el rebote
+double Formation::gapToEdge(float screenLeft, float screenRight) const {
+    const int left = firstSet(liveCols_);
+    if (left < 0) return std::numeric_limits<double>::infinity();
+    const int col = dir_ < 0 ? left : lastSet(liveCols_);
+    const double front = static_cast<double>(startPos_.x + col * spacingX_) + offsetX_;
+    if (dir_ < 0) return front - enemies_.half.x - screenLeft;
+    return screenRight - (front + enemies_.half.x);
 }
 
-void Formation::reset() {
-    enemies_.clear();
-    int topCount = 1;
-    int midCount = 0;
-    if (rows_ > 1) {
-        midCount = std::max(1, (rows_ - topCount) / 2);
-    }
-    int botCount = rows_ - topCount - midCount;
-    if (botCount < 0) { botCount = 0; midCount = rows_ - topCount; }
+double Formation::timeToEdge(float screenLeft, float screenRight) const {
+    if (speed_ <= 0.f) return std::numeric_limits<double>::infinity();
+    return std::max(0.0, gapToEdge(screenLeft, screenRight)) / speed_;
+}
 
-    for (int r = 0; r < rows_; ++r) {
-        const sf::Texture* tex = midTex_;
-        if (r < topCount) {
-            tex = topTex_;
-        } else if (r < topCount + midCount) {
-            tex = midTex_;
-        } else {
-            tex = botTex_;
-        }
+bool Formation::bounceAtEdge(float screenLeft, float screenRight) {
+    const double gap = gapToEdge(screenLeft, screenRight);
+    if (gap > EDGE_SLACK) return false;
+    // el frente queda justo en el borde: lo que quede del redondeo no pasa al rebote siguiente
+    offsetX_ += dir_ * gap;
+    bounce();
+    return true;
+}
 
+void Formation::bounce() {
+    offsetY_ += dropAmount_;
+    place();
+    dir_ *= -1;
+    // aumentar velocidad
+    speed_ *= bounceSpeedup_;
+    computeBounds();
+}
+
+// posición = casilla inicial + desplazamiento acumulado en double: sumar cada tick en float deriva
+// distinto según el paso, y con ella qué disparos rozan a quién
+void Formation::place() {
+    // los muertos también se desplazan: no importa dónde estén y el bucle queda sin saltos
+    float* x = enemies_.x.data();
+    float* y = enemies_.y.data();
+    for (int r = 0; r < rows_; ++r) {
+        const float rowY = static_cast<float>(static_cast<double>(startPos_.y + r * spacingY_) + offsetY_);
         for (int c = 0; c < cols_; ++c) {
-            sf::Vector2f pos{ startPos_.x + c * spacingX_, startPos_.y + r * spacingY_ };
-            enemies_.emplace_back(tex, pos);
+            const std::size_t i = static_cast<std::size_t>(r * cols_ + c);
+            x[i] = static_cast<float>(static_cast<double>(startPos_.x + c * spacingX_) + offsetX_);
+            y[i] = rowY;
         }
     }
+}
 
+void Formation::savePrevious() {
+    enemies_.savePrevious();
+}
+
+void Formation::reset() {
     dir_ = 1;
-    computeBounds();
+    build();
+}
+
+void Formation::restart(float speed, float dropAmount) {
+    speed_ = speed;
+    dropAmount_ = dropAmount;
+    reset();
 }
 
 int Formation::aliveCount() const {
     int cnt = 0;
-    for (const auto &e : enemies_) if (e.isActive()) ++cnt;
+    for (std::uint64_t w : occupancy_) cnt += std::popcount(w);
+    return cnt;
+}
+
+int Formation::liveColumnCount() const {
+    int cnt = 0;
+    for (std::uint64_t w : liveCols_) cnt += std::popcount(w);
     return cnt;
-}
\ No newline at end of file
+}
+
+int Formation::nthLiveColumn(int n) const {
+    for (std::size_t w = 0; w < liveCols_.size(); ++w) {
+        std::uint64_t bits = liveCols_[w];
+        const int cnt = std::popcount(bits);
+        if (n >= cnt) { n -= cnt; continue; }
+        // quita los n bits más bajos y toma el siguiente
+        while (n-- > 0) bits &= bits - 1;
+        return static_cast<int>(w * 64 + std::countr_zero(bits));
+    }
+    return -1;
+}
@@ -0,0 +1,68 @@
+#include "FramePacer.h"
+#include <SFML/System.hpp>
+#include <algorithm>
+
+namespace {
+
+float toUs(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<float, std::micro>(d).count();
+}
+
+}
+
+void FramePacer::configure(sf::Window& window, PacingMode mode, float targetHz) {
+    mode_ = mode;
+    targetHz_ = targetHz > 0.f ? targetHz : 120.f;
+    period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetHz_));
+    window.setVerticalSyncEnabled(mode_ == PacingMode::Vsync);
+    window.setFramerateLimit(0); // el limitador de SFML solo duerme: impreciso con el planificador de 1 ms
+    lastEnd_ = Clock::time_point{};
+    stats_ = Stats{};
+}
+
+void FramePacer::wait() {
+    if (mode_ != PacingMode::Limited) return;
+    const Clock::time_point start = Clock::now();
+    if (lastEnd_ == Clock::time_point{}) lastEnd_ = start;
+    const Clock::time_point deadline = lastEnd_ + period_;
+    stats_ = Stats{};
+    stats_.spinMarginUs = toUs(spinMargin_);
+    if (start >= deadline) {
+        // frame largo: se empieza a contar desde ahora en vez de encadenar frames cortos para recuperar
+        stats_.lateUs = toUs(start - deadline);
+        lastEnd_ = start;
+        return;
+    }
+    const Clock::time_point wakeTarget = deadline - spinMargin_;
+    if (wakeTarget > start) {
+        sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(wakeTarget - start).count()));
+        const Clock::time_point woke = Clock::now();
+        stats_.sleptUs = toUs(woke - start);
+        // el margen sube en cuanto el sleep se pasa y baja despacio mientras vaya sobrado
+        const Clock::duration oversleep = woke > wakeTarget ? woke - wakeTarget : Clock::duration{};
+        spinMargin_ = std::max(MIN_SPIN, std::max(spinMargin_ - spinMargin_ / 16, oversleep + MIN_SPIN));
+    }
+    const Clock::time_point spinStart = Clock::now();
+    while (Clock::now() < deadline) {}
+    const Clock::time_point end = Clock::now();
+    stats_.spunUs = toUs(end - spinStart);
+    if (spinStart > deadline) stats_.lateUs = toUs(spinStart - deadline);
+    // se mantiene la cadencia; solo si el hilo se despertó muy tarde se cuenta desde ahora
+    lastEnd_ = end - deadline > period_ / 4 ? end : deadline;
+}
+
+std::optional<PacingMode> FramePacer::parse(std::string_view name) {
+    if (name == "vsync") return PacingMode::Vsync;
+    if (name == "uncapped") return PacingMode::Uncapped;
+    if (name == "limit") return PacingMode::Limited;
+    return std::nullopt;
+}
+
+const char* FramePacer::name(PacingMode mode) {
+    switch (mode) {
+    case PacingMode::Vsync: return "vsync";
+    case PacingMode::Uncapped: return "uncapped";
+    case PacingMode::Limited: return "limit";
+    }
+    return "?";
+}
@@ -1,11 +1,34 @@
 #include "Game.h"
+#include "GameSim.h"
 #include "Menu.h"
+#include "EntityRenderer.h"
+#include "ParticleSystem.h"
+#include "TextureAtlas.h"
+#include "StatsOverlay.h"
+#include "UiLayer.h"
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "AssetManifest.h"
+#include "AudioMixer.h"
+#include "Replay.h"
+#include "ShieldMask.h"
+#include "SimPolicy.h"
+#include "BulletPool.h"
 #include "Formation.h"
-#include "Player.h"
-#include "Bullet.h"
 #include "Shield.h"
+#include "InputBindings.h"
+#include "LatencyProbe.h"
+#include "RenderSnapshot.h"
+#include "Profiler.h"
+#include "AllocTracker.h"
+#include "Percentile.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <random>
 
 Game::Game(unsigned int windowWidth, unsigned int windowHeight)
 : windowWidth_(windowWidth)
@@ -13,43 +36,229 @@ Game::Game(unsigned int windowWidth, unsigned int windowHeight)
 , window_(sf::VideoMode({ windowWidth_, windowHeight_ }), "Naves")
 , VIRTUAL_WIDTH_(windowWidth)
 , VIRTUAL_HEIGHT_(windowHeight)
-, rng_(static_cast<unsigned int>(std::random_device{}()))
 {
-    window_.setVerticalSyncEnabled(true);
+    // una pulsación = un KeyPressed y un KeyReleased: la autorepetición metería pulsaciones falsas en las acciones
+    window_.setKeyRepeatEnabled(false);
     gameView_.setCenter(sf::Vector2f(static_cast<float>(VIRTUAL_WIDTH_)/2.f, static_cast<float>(VIRTUAL_HEIGHT_)/2.f));
     gameView_.setSize(sf::Vector2f(static_cast<float>(VIRTUAL_WIDTH_), static_cast<float>(VIRTUAL_HEIGHT_)));
-    playerStart_ = sf::Vector2f(MARGIN_.x + (WINDOW_COLS * CELL_SIZE) / 2.f,
-                                MARGIN_.y + HUD_HEIGHT + (WINDOW_ROWS * CELL_SIZE) - CELL_SIZE * 1.5f);
 }
 
 Game::~Game() = default;
 
-bool Game::loadAssets() {
-    bool ok = true;
-    hasFont_ = font_.openFromFile("assets/fonts/font.ttf");
-    if (!hasFont_) { std::cerr << "[WARN] could not load font\n"; ok = false; }
-    if (!texPlayer_.loadFromFile("assets/textures/player.png")) { std::cerr << "[WARN] could not load player.png\n"; ok = false; }
-    if (!texBulletPlayer_.loadFromFile("assets/textures/bullet.png")) { std::cerr << "[WARN] could not load bullet.png\n"; ok = false; }
-    if (!texBulletEnemy_.loadFromFile("assets/textures/bullet_2.png")) { std::cerr << "[WARN] could not load bullet_2.png\n"; ok = false; }
-    if (!texAlienTop_.loadFromFile("assets/textures/alien_top.png")) { std::cerr << "[WARN] could not load alien_top.png\n"; ok = false; }
-    if (!texAlienMid_.loadFromFile("assets/textures/alien_mid.png")) { std::cerr << "[WARN] could not load alien_mid.png\n"; ok = false; }
-    if (!texAlienBot_.loadFromFile("assets/textures/alien_bottom.png")) { std::cerr << "[WARN] could not load alien_bottom.png\n"; ok = false; }
-    if (!texShield_.loadFromFile("assets/textures/shield.png")) { std::cerr << "[WARN] could not load shield.png\n"; ok = false; }
-
-    if (laserBuf_.loadFromFile("assets/sounds/laser_sound.mp3")) laserSound_.emplace(laserBuf_);
-    else std::cerr << "[WARN] could not load laser_sound.mp3\n";
-
-    explosionLoaded_ = explosionBuf_.loadFromFile("assets/sounds/explosion_enemy.mp3");
-    if (!explosionLoaded_) std::cerr << "[WARN] could not load explosion_enemy.mp3\n";
-
-    return ok;
+void Game::setTickRate(float hz) {
+    if (hz > 0.f) tickDt_ = 1.f / hz;
+}
+
+void Game::setMaxCatchUpTicks(int ticks) {
+    maxCatchUpTicks_ = std::max(1, ticks);
+}
+
+void Game::setPolyphony(std::size_t voices) {
+    if (voices > 0) polyphony_ = voices;
+}
+
+void Game::setRenderStall(float ms) {
+    renderStallMs_ = std::max(0.f, ms);
+}
+
+void Game::beginFrameAllocs() {
+    Profiler::instance().allocsByZone(zoneAllocsBefore_);
+    frameAllocStart_ = AllocTracker::thisThread().allocs;
+}
+
+// un frame en régimen no reserva nada, ni aquí ni en los ticks que corrieron mientras tanto;
+// lo que cambia de escena (menú, pausa, resultado, tamaño, overlay visible) sí puede y no cuenta
+void Game::checkFrameAllocs() {
+    const std::uint64_t mainAllocs = AllocTracker::thisThread().allocs - frameAllocStart_;
+    Profiler::instance().allocsByZone(zoneAllocsAfter_);
+    const bool overlay = statsOverlay_ && statsOverlay_->visible();
+    const std::uint32_t scene = static_cast<std::uint32_t>(state_) | (paused_ ? 4u : 0u) | (pausedForResult_ ? 8u : 0u) | (overlay ? 16u : 0u);
+    if (scene != allocScene_ || window_.getSize() != allocWindowSize_) {
+        allocScene_ = scene;
+        allocWindowSize_ = window_.getSize();
+        allocSteadyFrames_ = 0;
+        return;
+    }
+    if (state_ == AppState::Loading || overlay || ++allocSteadyFrames_ <= ALLOC_SETTLE_FRAMES) return;
+    ++allocCheckedFrames_;
+
+    bool zonesAllocated = false;
+    for (std::size_t i = 0; i < zoneAllocsAfter_.size(); ++i) {
+        const std::uint64_t before = i < zoneAllocsBefore_.size() ? zoneAllocsBefore_[i] : 0;
+        zonesAllocated |= zoneAllocsAfter_[i] != before;
+    }
+    if (mainAllocs == 0 && !zonesAllocated) return;
+    if (++allocFailedFrames_ > ALLOC_REPORT_LIMIT) return;
+    std::cerr << "[WARN] steady frame allocated " << mainAllocs << " times on the main thread; zones:";
+    for (std::size_t i = 0; i < zoneAllocsAfter_.size(); ++i) {
+        const std::uint64_t before = i < zoneAllocsBefore_.size() ? zoneAllocsBefore_[i] : 0;
+        if (zoneAllocsAfter_[i] != before)
+            std::cerr << ' ' << Profiler::instance().zoneName(static_cast<std::uint32_t>(i)) << " +" << (zoneAllocsAfter_[i] - before);
+    }
+    std::cerr << '\n';
+}
+
+void Game::setStressSweep(int steps, int frames, const std::string& csvPath) {
+    stressSteps_ = std::max(0, steps);
+    stressFrames_ = std::max(1, frames);
+    stressCsvPath_ = csvPath;
+}
+
+namespace {
+
+// prioridad en el mezclador: una explosión puede robar la voz de un disparo, no al revés
+constexpr std::uint8_t LASER_PRIORITY = 0;
+constexpr std::uint8_t EXPLOSION_PRIORITY = 1;
+
+// ráfagas de partículas por evento (ángulos en radianes, y hacia abajo: -π/2 es hacia arriba)
+const ParticleSystem::Burst EXPLOSION_BURST{ .count = 48, .speedMin = 30.f, .speedMax = 220.f, .lifeMin = 0.35f, .lifeMax = 0.8f,
+                                             .size = 4.f, .drag = 2.5f, .from = sf::Color(255, 200, 90), .to = sf::Color(200, 40, 20, 0) };
+// cascotes del escudo: salen del cráter hacia el lado del golpe y caen
+const ParticleSystem::Burst SHIELD_DEBRIS_UP{ .count = 14, .angle = -1.5707963f, .spread = 2.2f, .speedMin = 40.f, .speedMax = 140.f,
+                                              .lifeMin = 0.25f, .lifeMax = 0.5f, .size = 3.f, .gravity = 420.f,
+                                              .from = sf::Color(120, 230, 120), .to = sf::Color(40, 120, 40, 0) };
+const ParticleSystem::Burst SHIELD_DEBRIS_DOWN{ .count = 14, .angle = 1.5707963f, .spread = 2.2f, .speedMin = 40.f, .speedMax = 140.f,
+                                                .lifeMin = 0.25f, .lifeMax = 0.5f, .size = 3.f, .gravity = 420.f,
+                                                .from = sf::Color(120, 230, 120), .to = sf::Color(40, 120, 40, 0) };
+const ParticleSystem::Burst PLAYER_HIT_BURST{ .count = 120, .speedMin = 60.f, .speedMax = 320.f, .lifeMin = 0.5f, .lifeMax = 1.2f,
+                                              .size = 5.f, .drag = 1.5f, .from = sf::Color(200, 240, 255), .to = sf::Color(40, 80, 255, 0) };
+// fogonazo del disparo: pocas, rápidas y hacia arriba
+const ParticleSystem::Burst MUZZLE_FLASH_BURST{ .count = 6, .angle = -1.5707963f, .spread = 1.2f, .speedMin = 60.f, .speedMax = 160.f,
+                                                .lifeMin = 0.06f, .lifeMax = 0.14f, .size = 3.f, .drag = 6.f,
+                                                .from = sf::Color(255, 255, 200), .to = sf::Color(255, 160, 40, 0) };
+
+// milisegundos de t0 a t1
+float msSince(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1) {
+    return std::chrono::duration<float, std::milli>(t1 - t0).count();
+}
+
+}
+
+void Game::startLoading() {
+    loader_ = std::make_unique<AssetLoader>();
+    loader_->setPack(pack_.get());
+    for (const char* name : AssetManifest::ATLAS_SPRITES) loader_->addImage(name, AssetManifest::spritePath(name), AssetManifest::ATLAS_SPRITE_MAX);
+    // el escudo va aparte y a tamaño original (igual que lo lee --shield en las herramientas):
+    // de él salen la máscara de colisión y su propia textura
+    loader_->addImage("shield", AssetManifest::SHIELD);
+    loader_->addSound("laser", AssetManifest::LASER_SOUND);
+    loader_->addSound("explosion", AssetManifest::EXPLOSION_SOUND);
+    loader_->start();
+    stagedAssets_ = 0;
+    assetsOk_ = true;
+    state_ = AppState::Loading;
+}
+
+// sube al hilo principal lo que ya decodificaron los hilos, sin pasar del presupuesto del frame
+void Game::pumpLoading() {
+    PROFILE_ZONE("loading.stage");
+    sf::Clock budget;
+    while (budget.getElapsedTime().asSeconds() * 1000.f < UPLOAD_BUDGET_MS) {
+        std::optional<AssetLoader::Result> r = loader_->poll();
+        if (!r) break;
+        ++stagedAssets_;
+        if (!r->ok) {
+            std::cerr << "[WARN] could not load " << r->path << "\n";
+            assetsOk_ = false;
+            continue;
+        }
+        if (r->kind == AssetLoader::Kind::Image) {
+            loadedImages_.emplace_back(r->name, std::move(r->image));
+            continue;
+        }
+        // sin samples propios, los datos son del paquete mapeado (vive más que el mezclador)
+        const AssetLoader::SoundData& sd = r->sound;
+        std::optional<AudioMixer::ClipId> clip = mixer_->addClip(sd.data, sd.count, sd.channelCount, sd.sampleRate, sd.samples.empty());
+        if (!clip) { std::cerr << "[WARN] could not create mixer clip for " << r->path << "\n"; assetsOk_ = false; }
+        else if (r->name == "laser") laserClip_ = clip;
+        else explosionClip_ = clip;
+    }
+    if (loadingUi_ && loadingBarId_) {
+        const float done = static_cast<float>(loader_->decoded() + stagedAssets_);
+        const float total = static_cast<float>(std::max<std::size_t>(1, 2 * loader_->total()));
+        loadingUi_->setSize(*loadingBarId_, { LOADING_BAR_SIZE.x * done / total, LOADING_BAR_SIZE.y });
+    }
+    if (stagedAssets_ == loader_->total()) finishLoading();
+}
+
+void Game::finishLoading() {
+    PROFILE_ZONE("loading.finish");
+    loader_.reset();
+
+    // todos los sprites de juego van a un atlas: una sola textura que enlazar
+    atlas_ = std::make_unique<TextureAtlas>();
+    for (const char* name : AssetManifest::ATLAS_SPRITES) {
+        auto it = std::find_if(loadedImages_.begin(), loadedImages_.end(), [&](const auto& e) { return e.first == name; });
+        if (it != loadedImages_.end()) atlas_->add(name, it->second, AssetManifest::ATLAS_SPRITE_MAX);
+    }
+    auto shield = std::find_if(loadedImages_.begin(), loadedImages_.end(), [](const auto& e) { return e.first == "shield"; });
+    if (shield != loadedImages_.end()) {
+        // la forma de los escudos es el alfa de la imagen al tamaño con que se dibujan
+        const sf::Image& img = shield->second;
+        const sf::Vector2f size = sim_->config().shieldSize;
+        const sf::Vector2i pixels{ static_cast<int>(std::lround(size.x)), static_cast<int>(std::lround(size.y)) };
+        sim_->setShieldShape(ShieldMask::fromAlpha(img.getPixelsPtr(), img.getSize(), pixels));
+        entityRenderer_->setShieldImage(img);
+    }
+    loadedImages_.clear();
+    // la forma de los escudos forma parte de la partida: se fija antes de grabar o reproducir
+    if (recorder_) recorder_->begin(seed_, tickDt_, sim_->shieldShapeHash(), sim_->configHash());
+    if (replay_ && replay_->shieldShape() != sim_->shieldShapeHash())
+        std::cerr << "[WARN] replay was recorded with a different shield shape; it will diverge\n";
+    if (replay_ && replay_->config() != sim_->configHash())
+        std::cerr << "[WARN] replay was recorded with a different game configuration (--cols, --rows...); it will diverge\n";
+    if (!atlas_->build()) assetsOk_ = false;
+    auto useRegion = [&](EntityKind kind, const char* name) {
+        TextureAtlas::Region r = atlas_->region(name);
+        entityRenderer_->setRegion(kind, r.texture, r.rect);
+    };
+    useRegion(EntityKind::Player, "player");
+    useRegion(EntityKind::PlayerBullet, "bullet");
+    useRegion(EntityKind::EnemyBullet, "bullet_2");
+    useRegion(EntityKind::AlienTop, "alien_top");
+    useRegion(EntityKind::AlienMid, "alien_mid");
+    useRegion(EntityKind::AlienBottom, "alien_bottom");
+
+    // clips ya registrados: a partir de aquí el hilo de audio los lee
+    mixer_->play();
+
+    // la música se abre en streaming: solo lee la cabecera (desde el paquete, sin copiar)
+    const std::optional<AssetPack::View> music = pack_ ? pack_->find(AssetManifest::MUSIC) : std::nullopt;
+    bool musicOk = music ? bgMusic_.openFromMemory(music->data, music->size) : bgMusic_.openFromFile(std::string("assets/") + AssetManifest::MUSIC);
+    if (musicOk) { bgMusic_.setLooping(true); bgMusic_.play(); musicOn_ = true; }
+    if (musicIconId_) hud_->setString(*musicIconId_, musicOn_ ? "Off" : "On");
+
+    if (!assetsOk_) std::cerr << "Continuing in degraded mode\n";
+    loadingUi_.reset();
+    // la grabación empieza en partida, con la simulación recién creada con su semilla
+    state_ = replay_ ? AppState::Playing : AppState::Menu;
+    if (stressSteps_ > 0) return;
+    // desde aquí la partida es del hilo de simulación
+    simThread_ = std::make_unique<SimThread>();
+    simThread_->start(std::move(sim_), tickDt_, maxCatchUpTicks_, std::move(recorder_), std::move(replay_));
 }
 
 bool Game::init() {
-    if (!loadAssets()) std::cerr << "Continuing in degraded mode\n";
-    createView();
+    // un único fichero mapeado; sin él (desarrollo) se leen los ficheros sueltos de assets/
+    pack_ = std::make_unique<AssetPack>();
+    if (!pack_->open("assets.pak")) {
+        pack_.reset();
+        std::cerr << "[INFO] assets.pak not found, loading loose files from assets/\n";
+    }
 
-    if (bgMusic_.openFromFile("assets/music/bg_music.ogg")) { bgMusic_.setLooping(true); bgMusic_.play(); musicOn_ = true; }
+    // la fuente se carga ya: la necesita la pantalla de carga (y pesa 30 KB)
+    const std::optional<AssetPack::View> font = pack_ ? pack_->find(AssetManifest::FONT) : std::nullopt;
+    hasFont_ = font ? font_.openFromMemory(font->data, font->size) : font_.openFromFile(std::string("assets/") + AssetManifest::FONT);
+    if (!hasFont_) std::cerr << "[WARN] could not load font\n";
+    createView();
+    pacer_ = std::make_unique<FramePacer>();
+    pacer_->configure(window_, pacingMode_, pacingHz_);
+    latency_ = std::make_unique<LatencyProbe>();
+    if (!latencyLogPath_.empty() && !latency_->openLog(latencyLogPath_)) std::cerr << "[WARN] could not write " << latencyLogPath_ << "\n";
+    bindings_ = std::make_unique<InputBindings>();
+    if (!bindingsPath_.empty() && !bindings_->load(bindingsPath_)) std::cerr << "[WARN] could not load key bindings " << bindingsPath_ << "\n";
+    mixer_ = std::make_unique<AudioMixer>(polyphony_);
+    startLoading();
 
     menu_ = std::make_unique<Menu>(hasFont_ ? &font_ : nullptr, 80);
     menu_->setOptions({ "NEW GAME", "EXIT" }, { static_cast<float>(VIRTUAL_WIDTH_) / 2.f, static_cast<float>(VIRTUAL_HEIGHT_) / 2.f }, 140.f);
@@ -57,55 +266,94 @@ bool Game::init() {
     pauseMenu_ = std::make_unique<Menu>(hasFont_ ? &font_ : nullptr, 56);
     pauseMenu_->setOptions({ "RESUME", "RESTART", "EXIT TO MENU" }, { static_cast<float>(VIRTUAL_WIDTH_) / 2.f, static_cast<float>(VIRTUAL_HEIGHT_) / 2.f }, 96.f);
 
-    musicBtn_.setSize({48.f, 48.f});
-    musicBtn_.setPosition(MARGIN_);
-    musicBtn_.setFillColor(sf::Color(40,40,50));
-    musicBtn_.setOutlineColor(sf::Color(200,200,200));
-    musicBtn_.setOutlineThickness(-2.f);
-
-    if (hasFont_) {
-        musicIcon_.emplace(font_, musicOn_ ? "Off" : "On", 22);
-        musicIcon_->setFillColor(sf::Color::White);
-        auto rt = musicIcon_->getLocalBounds();
-        float ox = rt.position.x + rt.size.x * 0.5f;
-        float oy = rt.position.y + rt.size.y * 0.5f;
-        musicIcon_->setOrigin(sf::Vector2f(ox, oy));
-        sf::Vector2f bpos = musicBtn_.getPosition();
-        sf::Vector2f bsize = musicBtn_.getSize();
-        musicIcon_->setPosition(sf::Vector2f(bpos.x + bsize.x * 0.5f, bpos.y + bsize.y * 0.5f));
-    }
-
-    bullets_.reserve(64);
-    for (size_t i = 0; i < 64; ++i) bullets_.emplace_back(texBulletPlayer_.getSize().x ? &texBulletPlayer_ : nullptr);
-    enemyBullets_.reserve(32);
-    for (size_t i = 0; i < 32; ++i) enemyBullets_.emplace_back(texBulletEnemy_.getSize().x ? &texBulletEnemy_ : nullptr);
-
-    if (hasFont_) {
-        scoreText_.emplace(font_, "Score: 0", 28);
-        scoreText_->setFillColor(sf::Color::White);
-        livesText_.emplace(font_, "Lives: 3", 28);
-        livesText_->setFillColor(sf::Color::White);
-        overlayTitle_.emplace(font_, "", 64);
-        overlayTitle_->setFillColor(sf::Color::White);
-        overlaySub_.emplace(font_, "", 28);
-        overlaySub_->setFillColor(sf::Color(200,200,200));
-    }
-
-    player_ = std::make_unique<Player>(texPlayer_.getSize().x ? &texPlayer_ : nullptr, playerStart_);
-    formation_ = createFormation();
-
-    explosionSounds_.clear();
-    if (explosionLoaded_) {
-        const size_t POOL_SIZE = 8;
-        explosionSounds_.reserve(POOL_SIZE);
-        for (size_t i = 0; i < POOL_SIZE; ++i) explosionSounds_.emplace_back(explosionBuf_);
-        explosionSoundIndex_ = 0;
+    buildUi();
+
+    if (stressSteps_ > 0 && (!replayPath_.empty() || !recordPath_.empty())) {
+        std::cerr << "[WARN] --record and --replay are ignored in stress mode\n";
+        replayPath_.clear();
+        recordPath_.clear();
     }
+    if (!replayPath_.empty()) {
+        replay_ = std::make_unique<Replay>();
+        if (replay_->load(replayPath_)) {
+            tickDt_ = replay_->dt();
+            if (!recordPath_.empty()) { std::cerr << "[WARN] --record is ignored while replaying\n"; recordPath_.clear(); }
+        } else {
+            std::cerr << "[WARN] could not load replay " << replayPath_ << "\n";
+            replay_.reset();
+        }
+    }
+    seed_ = replay_ ? replay_->seed() : std::random_device{}();
+    SimConfig cfg = simConfig_;
+    cfg.margin = MARGIN_;
+    sim_ = std::make_unique<GameSim>(cfg, seed_);
+    if (!recordPath_.empty()) recorder_ = std::make_unique<ReplayRecorder>(); // begin() al acabar la carga
+
+    statsOverlay_ = std::make_unique<StatsOverlay>(hasFont_ ? &font_ : nullptr);
+
+    entityRenderer_ = std::make_unique<EntityRenderer>();
+    entityRenderer_->configure(sim_->config());
+    particles_ = std::make_unique<ParticleSystem>();
 
     resetGameState();
     return true;
 }
 
+void Game::buildUi() {
+    // HUD: botón de música arriba a la izquierda, puntuación a su derecha, vidas abajo
+    hud_ = std::make_unique<UiLayer>();
+    const sf::Vector2f btnSize{48.f, 48.f};
+    musicBtnId_ = hud_->addRect(btnSize, sf::Color(40,40,50), sf::Color(200,200,200), -2.f);
+    hud_->place(musicBtnId_, UiPlacement{ {0.f, 0.f}, MARGIN_, {0.f, 0.f} });
+
+    resultUi_ = std::make_unique<UiLayer>();
+    resultUi_->addBackdrop(sf::Color(0,0,0,200));
+
+    // pantalla de carga: barra centrada con su marco
+    loadingUi_ = std::make_unique<UiLayer>();
+    const UiPlacement barPlace{ {0.5f, 0.5f}, {-LOADING_BAR_SIZE.x * 0.5f, 0.f}, {0.f, 0.5f} };
+    UiLayer::Id frame = loadingUi_->addRect(LOADING_BAR_SIZE, sf::Color(40,40,50), sf::Color(200,200,200), 2.f);
+    loadingUi_->place(frame, barPlace);
+    loadingBarId_ = loadingUi_->addRect({ 0.f, LOADING_BAR_SIZE.y }, sf::Color(120,230,120));
+    loadingUi_->place(*loadingBarId_, barPlace);
+
+    if (!hasFont_) return;
+    UiLayer::Id loadingText = loadingUi_->addText(font_, "LOADING", 48, sf::Color::White);
+    loadingUi_->place(loadingText, UiPlacement{ {0.5f, 0.5f}, {0.f, -60.f}, {0.5f, 0.5f} });
+
+    musicIconId_ = hud_->addText(font_, musicOn_ ? "Off" : "On", 22, sf::Color::White);
+    hud_->place(*musicIconId_, UiPlacement{ {0.f, 0.f}, MARGIN_ + btnSize * 0.5f, {0.5f, 0.5f} });
+    scoreTextId_ = hud_->addText(font_, "Score: 0", 28, sf::Color::White);
+    hud_->place(*scoreTextId_, UiPlacement{ {0.f, 0.f}, { MARGIN_.x + btnSize.x + 12.f, MARGIN_.y + btnSize.y * 0.5f }, {0.f, 0.5f} });
+    livesTextId_ = hud_->addText(font_, "Lives: 3", 28, sf::Color::White);
+    hud_->place(*livesTextId_, UiPlacement{ {0.f, 1.f}, { MARGIN_.x + 8.f, -MARGIN_.y - 8.f }, {0.f, 1.f} });
+
+    overlayTitleId_ = resultUi_->addText(font_, "", 64, sf::Color::White);
+    resultUi_->place(*overlayTitleId_, UiPlacement{ {0.5f, 0.5f}, {0.f, -24.f}, {0.5f, 0.5f} });
+    overlaySubId_ = resultUi_->addText(font_, "", 28, sf::Color(200,200,200));
+    resultUi_->place(*overlaySubId_, UiPlacement{ {0.5f, 0.5f}, {0.f, 40.f}, {0.5f, 0.5f} });
+}
+
+// solo toca los textos (y ensucia la capa) si el valor mostrado cambió
+void Game::syncHud(const RenderSnapshot& snap) {
+    if (snap.score != shownScore_) {
+        shownScore_ = snap.score;
+        if (scoreTextId_) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "Score: %d", shownScore_);
+            hud_->setAscii(*scoreTextId_, buf);
+        }
+    }
+    if (snap.lives != shownLives_) {
+        shownLives_ = snap.lives;
+        if (livesTextId_) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "Lives: %d", shownLives_);
+            hud_->setAscii(*livesTextId_, buf);
+        }
+    }
+}
+
 void Game::createView() {
     updateGameViewForWindow(window_.getSize().x, window_.getSize().y);
 }
@@ -124,91 +372,100 @@ void Game::updateGameViewForWindow(unsigned int winW, unsigned int winH) {
     gameView_.setViewport(sf::FloatRect({vpL, vpT}, {vpW, vpH}));
 }
 
-std::unique_ptr<Formation> Game::createFormation() {
-    float movement = 40.f + (wave_ - 1) * 6.f;
-    float descend = 18.f + (wave_ - 1) * 3.f;
-    const float formationStartX = MARGIN_.x + 2.f * CELL_SIZE;
-    const float formationStartY = MARGIN_.y + HUD_HEIGHT + 1.f * CELL_SIZE;
-    const float spacingX = static_cast<float>(CELL_SIZE) * 1.65f;
-    const float spacingY = static_cast<float>(CELL_SIZE) * 1.15f;
-    return std::make_unique<Formation>(
-        texAlienTop_.getSize().x ? &texAlienTop_ : nullptr,
-        texAlienMid_.getSize().x ? &texAlienMid_ : nullptr,
-        texAlienBot_.getSize().x ? &texAlienBot_ : nullptr,
-        ENEMY_COLS, ENEMY_ROWS,
-        sf::Vector2f{ formationStartX, formationStartY },
-        spacingX, spacingY,
-        movement, descend
-    );
-}
-
-void Game::spawnNextWave() {
-    wave_ += 1;
-    for (auto &b : bullets_) b.deactivate();
-    for (auto &b : enemyBullets_) b.deactivate();
-    formation_ = createFormation();
-    enemyShootTimer_ = enemyShootDist_(rng_) / (1.f + 0.08f * (wave_ - 1));
-}
-
 void Game::resetGameState() {
-    wave_ = 1;
-    player_->setPosition(playerStart_);
-    formation_ = createFormation();
-    for (auto &b : bullets_) b.deactivate();
-    for (auto &b : enemyBullets_) b.deactivate();
-    shields_.clear();
+    // la atiende el hilo de simulación: reset si la partida ya avanzó y, durante un replay,
+    // devuelve el control al jugador. Hasta entonces syncSim no hace caso de sus Frames
+    if (simThread_) simThread_->reset();
+    if (particles_) particles_->clear();
     pausedForResult_ = false;
     paused_ = false;
-    score_ = 0;
-    lives_ = 3;
-    if (scoreText_) scoreText_->setString("Score: 0");
-    if (livesText_) livesText_->setString("Lives: 3");
-
-    float shieldsY = player_->bounds().position.y - 120.f;
-    sf::Vector2f desiredSize{ 120.f, 60.f };
-    float padding = 48.f;
-    float available = static_cast<float>(VIRTUAL_WIDTH_) - 2.f * padding;
-    float totalW = 4.f * desiredSize.x;
-    float gapBetween = 0.f;
-    if (available > totalW) gapBetween = (available - totalW) / 3.f + desiredSize.x;
-    else gapBetween = desiredSize.x + 12.f;
-    float firstCenterX = padding + desiredSize.x * 0.5f;
-    for (int i = 0; i < 4; ++i) {
-        float centerX = firstCenterX + static_cast<float>(i) * gapBetween;
-        if (texShield_.getSize().x) shields_.emplace_back(&texShield_, sf::Vector2f{ centerX - desiredSize.x / 2.f, shieldsY }, SHIELD_HP, desiredSize);
-    }
-
-    shootTimer_ = 0.f;
-    enemyShootTimer_ = enemyShootDist_(rng_);
 }
 
-bool Game::trySpawnFromColumn(int col) {
-    if (!formation_) return false;
-    auto &en = formation_->enemies();
-    for (int r = ENEMY_ROWS - 1; r >= 0; --r) {
-        int idx = r * ENEMY_COLS + col;
-        if (idx < 0 || idx >= static_cast<int>(en.size())) continue;
-        auto &enemy = en[idx];
-        if (enemy.isActive()) {
-            sf::FloatRect eb = enemy.bounds();
-            sf::Vector2f shotPos{ eb.position.x + eb.size.x / 2.f, eb.position.y + eb.size.y + 4.f };
-            for (auto &b : enemyBullets_) {
-                if (!b.isActive()) {
-                    b.spawn(shotPos, 350.f);
-                    return true;
-                }
-            }
-            return false;
+void Game::handleSimEvents() {
+    SimEvent ev;
+    while (simThread_->pollEvent(ev)) {
+        emitParticles(ev, simThread_->current().snapshot.shields);
+        switch (ev.type) {
+        case SimEventType::PlayerShot:
+            if (laserClip_) mixer_->play(*laserClip_, LASER_PRIORITY);
+            break;
+        case SimEventType::EnemyKilled:
+            if (explosionClip_) mixer_->play(*explosionClip_, EXPLOSION_PRIORITY);
+            break;
+        default:
+            break;
         }
     }
-    return false;
 }
 
-bool Game::rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b) {
-    return !(a.position.x + a.size.x < b.position.x ||
-             b.position.x + b.size.x < a.position.x ||
-             a.position.y + a.size.y < b.position.y ||
-             b.position.y + b.size.y < a.position.y);
+// shields: los de la partida que emitió el evento (para saber por qué lado salen los cascotes)
+void Game::emitParticles(const SimEvent& ev, const std::vector<Shield>& shields) {
+    switch (ev.type) {
+    case SimEventType::PlayerShot:
+        particles_->emit(MUZZLE_FLASH_BURST, ev.position);
+        break;
+    case SimEventType::EnemyKilled:
+        particles_->emit(EXPLOSION_BURST, ev.position);
+        break;
+    case SimEventType::ShieldHit: {
+        const std::size_t s = static_cast<std::size_t>(ev.value);
+        const bool below = s < shields.size() && ev.position.y > shields[s].bounds().position.y + shields[s].bounds().size.y * 0.5f;
+        particles_->emit(below ? SHIELD_DEBRIS_DOWN : SHIELD_DEBRIS_UP, ev.position);
+        break;
+    }
+    case SimEventType::PlayerHit:
+        particles_->emit(PLAYER_HIT_BURST, ev.position);
+        break;
+    default:
+        break;
+    }
+}
+
+// le dice al hilo de simulación si debe avanzar y recoge lo que publicó desde el frame anterior
+void Game::syncSim(bool advance) {
+    if (!simThread_) return;
+    if (advance != simAdvancing_) {
+        simAdvancing_ = advance;
+        if (advance) {
+            // durante menús y pausas no se mandan acciones de juego: al volver va lo que diga el teclado
+            std::uint32_t held = 0;
+            for (std::size_t i = 0; i < GAMEPLAY_ACTION_COUNT; ++i)
+                if (window_.hasFocus() && bindings_->isHeld(static_cast<Action>(i))) held |= 1u << i;
+            simThread_->resume(held);
+        } else {
+            simThread_->pause();
+        }
+    }
+    const SimThread::Frame& frame = simThread_->latest();
+    ticksLastFrame_ = static_cast<int>(frame.ticks - shownTicks_);
+    shownTicks_ = frame.ticks;
+    // al acabar un replay el teclado vuelve a mandar: el próximo resume lleva lo que esté pulsado
+    if (simReplaying_ && !frame.replaying) {
+        simAdvancing_ = false;
+        if (exitAfterReplay_) { state_ = AppState::Menu; exitCountdown_ = EXIT_MENU_FRAMES; }
+    }
+    simReplaying_ = frame.replaying;
+    // con órdenes aún sin atender el Frame es anterior a ellas (p. ej. sigue en game over tras un reset)
+    if (frame.commandSerial == simThread_->commandsSent() && frame.halted != pausedForResult_) {
+        pausedForResult_ = frame.halted;
+        if (pausedForResult_) {
+            if (overlayTitleId_) { resultUi_->setString(*overlayTitleId_, "GAME OVER"); resultUi_->setFillColor(*overlayTitleId_, sf::Color::Red); }
+            if (overlaySubId_) resultUi_->setString(*overlaySubId_, "Press ENTER to restart");
+        }
+    }
+    // pulsaciones cuyo tick ya está en este Frame: se dibujan en este frame
+    for (;;) {
+        if (!heldPress_) {
+            SimThread::Press press;
+            if (!simThread_->pollPress(press)) break;
+            heldPress_ = press;
+        }
+        if (heldPress_->ticks > frame.ticks) break;
+        latency_->consumed(heldPress_->inputNs, heldPress_->tickNs);
+        heldPress_.reset();
+    }
+    handleSimEvents();
+    syncHud(frame.snapshot);
 }
 
 void Game::handleEvents() {
@@ -218,13 +475,40 @@ void Game::handleEvents() {
         if (ev.is<sf::Event::Resized>()) {
             auto r = ev.getIf<sf::Event::Resized>();
             if (r) updateGameViewForWindow(static_cast<unsigned int>(r->size.x), static_cast<unsigned int>(r->size.y));
+            if (entityRenderer_) entityRenderer_->invalidateStatic();
         }
-        if (ev.is<sf::Event::KeyPressed>()) {
-            auto k = ev.getIf<sf::Event::KeyPressed>();
-            if (!k) continue;
-            if (k->code == sf::Keyboard::Key::Escape && !pausedForResult_) paused_ = !paused_;
-            if (pausedForResult_) {
-                if (k->code == sf::Keyboard::Key::Enter || k->code == sf::Keyboard::Key::Space) resetGameState();
+        // sin foco no llegan los KeyReleased: se sueltan las acciones de juego
+        if (ev.is<sf::Event::FocusLost>() && simAdvancing_) {
+            const std::uint64_t now = actionClockNs();
+            for (std::size_t i = 0; i < GAMEPLAY_ACTION_COUNT; ++i) simThread_->pushAction(ActionEvent{ now, static_cast<Action>(i), false });
+        }
+        if (state_ == AppState::Loading) continue;
+        const auto* kp = ev.getIf<sf::Event::KeyPressed>();
+        const auto* kr = ev.getIf<sf::Event::KeyReleased>();
+        // los menús navegan con las mismas acciones que el juego: una tecla reasignada vale en ambos
+        std::uint32_t pressedActions = 0;
+        if (kp || kr) {
+            const std::uint32_t actions = bindings_->actions(kp ? kp->code : kr->code);
+            const bool pressed = kp != nullptr;
+            auto has = [&](Action a) { return (actions >> static_cast<unsigned>(a)) & 1u; };
+            // las de juego van al hilo de simulación y esperan a su tick; las demás se atienden ya
+            const std::uint64_t now = actionClockNs();
+            for (std::size_t i = 0; i < GAMEPLAY_ACTION_COUNT && simAdvancing_; ++i)
+                if (has(static_cast<Action>(i))) simThread_->pushAction(ActionEvent{ now, static_cast<Action>(i), pressed });
+            if (pressed) {
+                pressedActions = actions;
+                if (has(Action::Pause) && !pausedForResult_) paused_ = !paused_;
+                if (has(Action::ToggleStats) && statsOverlay_) statsOverlay_->toggle();
+                if (has(Action::CyclePacing)) {
+                    const auto next = static_cast<PacingMode>((static_cast<int>(pacer_->mode()) + 1) % 3);
+                    pacer_->configure(window_, next, pacingHz_);
+                    std::cerr << "[INFO] pacing: " << FramePacer::name(next) << "\n";
+                }
+                if (has(Action::WriteTrace)) {
+                    if (Profiler::instance().writeChromeTrace("trace.json")) std::cerr << "[INFO] wrote trace.json\n";
+                    else std::cerr << "[WARN] could not write trace.json\n";
+                }
+                if (pausedForResult_ && has(Action::Confirm)) resetGameState();
             }
         }
         if (ev.is<sf::Event::MouseButtonPressed>()) {
@@ -233,25 +517,20 @@ void Game::handleEvents() {
             if (mb->button == sf::Mouse::Button::Left) {
                 sf::Vector2i pix = sf::Mouse::getPosition(window_);
                 sf::Vector2f mp = window_.mapPixelToCoords(pix, window_.getDefaultView());
-                if (musicBtn_.getGlobalBounds().contains(mp)) {
+                if (hud_->bounds(musicBtnId_).contains(mp)) {
                     if (bgMusic_.getStatus() == sf::SoundSource::Status::Playing) { bgMusic_.pause(); musicOn_ = false; }
                     else { bgMusic_.play(); musicOn_ = true; }
-                    if (musicIcon_) musicIcon_->setString(musicOn_ ? "Off" : "On");
+                    if (musicIconId_) hud_->setString(*musicIconId_, musicOn_ ? "Off" : "On");
                 }
             }
         }
         if (state_ == AppState::Menu) {
-            sf::View prev = window_.getView();
-            window_.setView(window_.getDefaultView());
-            if (menu_) menu_->processEvent(ev, window_);
-            window_.setView(prev);
+            if (menu_) menu_->processEvent(ev, pressedActions, window_);
             continue;
         }
         if (paused_ && !pausedForResult_) {
-            sf::View prev = window_.getView();
-            window_.setView(window_.getDefaultView());
             if (pauseMenu_) {
-                pauseMenu_->processEvent(ev, window_);
+                pauseMenu_->processEvent(ev, pressedActions, window_);
                 if (pauseMenu_->consumeConfirm()) {
                     int sel = pauseMenu_->getSelectedIndex();
                     if (sel == 0) paused_ = false;
@@ -259,14 +538,18 @@ void Game::handleEvents() {
                     else if (sel == 2) { paused_ = false; state_ = AppState::Menu; }
                 }
             }
-            window_.setView(prev);
             continue;
         }
     }
 }
 
 void Game::update(float dt) {
+    if (state_ == AppState::Loading) {
+        pumpLoading();
+        return;
+    }
     if (state_ == AppState::Menu) {
+        syncSim(false);
         if (menu_) {
             menu_->update(dt);
             if (menu_->consumeConfirm()) {
@@ -277,96 +560,12 @@ void Game::update(float dt) {
         }
         return;
     }
+    // los ticks corren en su hilo a su ritmo; aquí solo se recoge el último Frame
+    syncSim(!paused_ && !pausedForResult_);
     if (paused_ || pausedForResult_) return;
-    shootTimer_ -= dt; if (shootTimer_ < 0.f) shootTimer_ = 0.f;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) player_->moveLeft(dt);
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) player_->moveRight(dt);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space) && shootTimer_ <= 0.f) {
-        sf::FloatRect pb = player_->bounds();
-        sf::Vector2f bulletPos{ pb.position.x + pb.size.x / 2.f, pb.position.y - 6.f };
-        for (auto &b : bullets_) {
-            if (!b.isActive()) { b.spawn(bulletPos, -480.f); if (laserSound_) laserSound_->play(); shootTimer_ = SHOOT_COOLDOWN; break; }
-        }
-    }
-    player_->update(dt);
-    for (auto &b : bullets_) b.update(dt);
-    for (auto &b : enemyBullets_) b.update(dt);
-    if (formation_) formation_->update(dt, MARGIN_.x, static_cast<float>(VIRTUAL_WIDTH_) - MARGIN_.x);
-    enemyShootTimer_ -= dt;
-    if (enemyShootTimer_ <= 0.f) {
-        int tries = ENEMY_COLS; bool spawned = false;
-        while (tries-- > 0 && !spawned) {
-            int col = enemyColDist_(rng_);
-            spawned = trySpawnFromColumn(col);
-        }
-        enemyShootTimer_ = enemyShootDist_(rng_) / (1.f + 0.08f * (wave_ - 1));
-    }
-    for (auto &b : bullets_) {
-        if (!b.isActive()) continue;
-        bool hitShield = false;
-        for (auto &s : shields_) {
-            if (!s.isActive()) continue;
-            if (rectsIntersect(s.bounds(), b.bounds())) { b.deactivate(); hitShield = true; break; }
-        }
-        if (hitShield) continue;
-        for (auto &e : formation_->enemies()) {
-            if (!e.isActive()) continue;
-            if (rectsIntersect(b.bounds(), e.bounds())) {
-                b.deactivate();
-                e.setActive(false);
-                if (explosionLoaded_ && !explosionSounds_.empty()) {
-                    explosionSounds_[explosionSoundIndex_].setBuffer(explosionBuf_);
-                    explosionSounds_[explosionSoundIndex_].play();
-                    explosionSoundIndex_ = (explosionSoundIndex_ + 1) % explosionSounds_.size();
-                }
-                score_ += 10;
-                if (scoreText_) scoreText_->setString("Score: " + std::to_string(score_));
-                break;
-            }
-        }
-    }
-    for (auto &b : enemyBullets_) {
-        if (!b.isActive()) continue;
-        bool hitShield = false;
-        for (auto &s : shields_) {
-            if (!s.isActive()) continue;
-            if (rectsIntersect(s.bounds(), b.bounds())) { b.deactivate(); s.takeDamage(1); hitShield = true; break; }
-        }
-        if (hitShield) continue;
-        if (rectsIntersect(b.bounds(), player_->bounds())) {
-            b.deactivate();
-            lives_ -= 1;
-            if (livesText_) livesText_->setString("Lives: " + std::to_string(lives_));
-            if (lives_ <= 0) {
-                pausedForResult_ = true;
-                if (overlayTitle_) { overlayTitle_->setString("GAME OVER"); overlayTitle_->setFillColor(sf::Color::Red); }
-                if (overlaySub_) overlaySub_->setString("Press ENTER to restart");
-            } else {
-                player_->setPosition(playerStart_);
-            }
-        }
-    }
-    for (auto &e : formation_->enemies()) {
-        if (!e.isActive()) continue;
-        for (auto &s : shields_) {
-            if (!s.isActive()) continue;
-            if (rectsIntersect(e.bounds(), s.bounds())) {
-                s.takeDamage(SHIELD_HP);
-                break;
-            }
-        }
-        sf::FloatRect eb = e.bounds();
-        if (eb.position.y + eb.size.y >= playerStart_.y - CELL_SIZE * 0.5f) {
-            pausedForResult_ = true;
-            if (overlayTitle_) { overlayTitle_->setString("GAME OVER"); overlayTitle_->setFillColor(sf::Color::Red); }
-            if (overlaySub_) overlaySub_->setString("Press ENTER to restart");
-            break;
-        }
-    }
-    bool anyAlive = false;
-    for (auto &e : formation_->enemies()) { if (e.isActive()) { anyAlive = true; break; } }
-    if (!anyAlive) {
-        spawnNextWave();
+    {
+        PROFILE_ZONE("update.particles");
+        particles_->update(dt);
     }
     bool menuVisible = (state_ == AppState::Menu) || (state_ == AppState::Playing && (paused_ || pausedForResult_));
     if (bgMusic_.getStatus() == sf::SoundSource::Status::Playing) {
@@ -384,104 +583,269 @@ void Game::update(float dt) {
 
 void Game::render() {
     window_.clear(sf::Color(18,18,28));
+    if (state_ == AppState::Loading) {
+        window_.setView(window_.getDefaultView());
+        if (loadingUi_) loadingUi_->draw(window_);
+        return;
+    }
     if (state_ == AppState::Menu) {
         window_.setView(window_.getDefaultView());
-        sf::RectangleShape fullBg(sf::Vector2f(static_cast<float>(window_.getSize().x), static_cast<float>(window_.getSize().y)));
-        fullBg.setFillColor(sf::Color(8,8,12));
-        window_.draw(fullBg);
         if (menu_) menu_->draw(window_);
-        window_.display();
         return;
     }
     if (paused_ || pausedForResult_) {
+        // el fondo opaco del menú de pausa y el velo de resultado tapan la partida
         window_.setView(window_.getDefaultView());
-        sf::RectangleShape fullBg(sf::Vector2f(static_cast<float>(window_.getSize().x), static_cast<float>(window_.getSize().y)));
-        fullBg.setFillColor(sf::Color(0,0,0,200));
-        window_.draw(fullBg);
-        if (paused_ && !pausedForResult_) {
-            if (pauseMenu_) pauseMenu_->draw(window_);
-        }
-        if (pausedForResult_) {
-            if (hasFont_ && overlayTitle_ && overlaySub_) {
-                sf::Vector2u cur = window_.getSize();
-                sf::FloatRect rt = overlayTitle_->getLocalBounds();
-                float ox = rt.position.x + rt.size.x * 0.5f;
-                float oy = rt.position.y + rt.size.y * 0.5f;
-                overlayTitle_->setOrigin(sf::Vector2f(ox, oy));
-                overlayTitle_->setPosition(sf::Vector2f(static_cast<float>(cur.x)/2.f, static_cast<float>(cur.y)/2.f - 24.f));
-                sf::FloatRect rs = overlaySub_->getLocalBounds();
-                float sox = rs.position.x + rs.size.x * 0.5f;
-                float soy = rs.position.y + rs.size.y * 0.5f;
-                overlaySub_->setOrigin(sf::Vector2f(sox, soy));
-                overlaySub_->setPosition(sf::Vector2f(static_cast<float>(cur.x)/2.f, static_cast<float>(cur.y)/2.f + 40.f));
-                window_.draw(*overlayTitle_);
-                window_.draw(*overlaySub_);
-            }
-        }
-        window_.display();
+        if (pausedForResult_) resultUi_->draw(window_);
+        else if (pauseMenu_) pauseMenu_->draw(window_);
         return;
     }
-    window_.setView(gameView_);
-    for (auto &s : shields_) s.draw(window_);
-    if (formation_) formation_->draw(window_);
-    for (auto &b : bullets_) if (b.isActive()) b.draw(window_);
-    for (auto &b : enemyBullets_) if (b.isActive()) b.draw(window_);
-    if (player_) player_->draw(window_);
-    window_.setView(window_.getDefaultView());
-    sf::Vector2u curSize = window_.getSize();
-    window_.draw(musicBtn_);
-    if (musicIcon_) window_.draw(*musicIcon_);
+    if (!simThread_) return;
     {
-        sf::Vector2f btnPos = musicBtn_.getPosition();
-        sf::Vector2f btnSize = musicBtn_.getSize();
-        const float paddingX = 12.f;
-        const float startX = btnPos.x + btnSize.x + paddingX;
-        const float centerY = btnPos.y + btnSize.y * 0.5f;
-        if (scoreText_) {
-            sf::FloatRect tb = scoreText_->getLocalBounds();
-            scoreText_->setOrigin(sf::Vector2f(0.f, tb.position.y + tb.size.y * 0.5f));
-            scoreText_->setPosition(sf::Vector2f(startX, centerY));
-            window_.draw(*scoreText_);
-        }
+        PROFILE_ZONE("render.entities");
+        window_.setView(gameView_);
+        // el Frame es el final de su tick: se interpola con lo que ha pasado desde entonces
+        const SimThread::Frame& frame = simThread_->current();
+        const std::uint64_t now = actionClockNs();
+        const float alpha = now > frame.tickNs ? std::min(1.f, static_cast<float>(now - frame.tickNs) * 1e-9f / tickDt_) : 0.f;
+        entityRenderer_->draw(window_, frame.snapshot, alpha);
+    }
+    {
+        PROFILE_ZONE("render.particles");
+        particles_->draw(window_);
+    }
+    PROFILE_ZONE("render.hud");
+    window_.setView(window_.getDefaultView());
+    hud_->draw(window_);
+}
+
+void Game::drawStats(float frameDt) {
+    if (!statsOverlay_) return;
+    statsOverlay_->pushFrameTime(frameDt);
+    statsElapsed_ += frameDt;
+    const AudioMixer::Counters audio = mixer_->takeFrame();
+    peakStolen_ = std::max(peakStolen_, audio.stolen);
+    peakDropped_ = std::max(peakDropped_, audio.dropped);
+    peakMixNs_ = std::max(peakMixNs_, audio.mixMaxNs);
+    if (statsOverlay_->update(frameDt)) {
+        const SpriteBatch::Stats& rs = entityRenderer_->stats();
+        const std::uint64_t texels = entityRenderer_->shieldTexelsUploaded();
+        const float texelsPerSec = statsElapsed_ > 0.f ? static_cast<float>(texels - lastShieldTexels_) / statsElapsed_ : 0.f;
+        lastShieldTexels_ = texels;
+        const std::uint64_t rebuilds = entityRenderer_->staticRebuilds();
+        const float rebuildsPerSec = statsElapsed_ > 0.f ? static_cast<float>(rebuilds - lastStaticRebuilds_) / statsElapsed_ : 0.f;
+        lastStaticRebuilds_ = rebuilds;
+        statsElapsed_ = 0.f;
+        const LatencyProbe::Summary lat = latency_->summarize();
+        const FramePacer::Stats& ps = pacer_->stats();
+        const ParticleSystem::Stats parts = particles_->stats();
+        particles_->resetStats();
+        const SimThread::TickStats ts = simThread_ ? simThread_->current().stats : SimThread::TickStats{};
+        const std::uint64_t pairs = simThread_ ? simThread_->current().snapshot.pairsTested : 0;
+        char pacing[96];
+        if (pacer_->mode() == PacingMode::Limited)
+            std::snprintf(pacing, sizeof(pacing), "%s %.0f Hz  sleep %.2f spin %.2f late %.2f ms", FramePacer::name(pacer_->mode()), pacer_->targetHz(),
+                          ps.sleptUs / 1000.f, ps.spunUs / 1000.f, ps.lateUs / 1000.f);
+        else
+            std::snprintf(pacing, sizeof(pacing), "%s", FramePacer::name(pacer_->mode()));
+        char buf[768];
+        std::snprintf(buf, sizeof(buf),
+                      "ticks/frame %d  dropped %llu\nsim %.1f Hz  tick p50/p99 %.2f/%.2f ms  late p99 %.2f max %.2f ms\n"
+                      "draw calls %zu  vertices %zu\nparticles %zu/%zu  peak %zu  dropped %llu\npairs/tick %llu  hud rasters %llu\nshield texels uploaded/s %.0f  static layer rebuilds/s %.1f\n"
+                      "voices %zu/%zu  stolen %llu  dropped %llu (max/frame)  mix max %.2f ms\npacing %s\n"
+                      "latency ms (p50/p99, %zu presses)\n  input>tick %.2f/%.2f  tick>display %.2f/%.2f  total %.2f/%.2f",
+                      ticksLastFrame_, static_cast<unsigned long long>(ts.dropped),
+                      ts.hz, ts.intervalP50, ts.intervalP99, ts.lateP99, ts.lateMax,
+                      rs.drawCalls, rs.vertices,
+                      particles_->size(), particles_->capacity(), parts.peak, static_cast<unsigned long long>(parts.dropped),
+                      static_cast<unsigned long long>(pairs),
+                      static_cast<unsigned long long>(hud_->rasterCount()),
+                      texelsPerSec, rebuildsPerSec,
+                      mixer_->activeVoices(), mixer_->polyphony(),
+                      static_cast<unsigned long long>(peakStolen_), static_cast<unsigned long long>(peakDropped_),
+                      static_cast<double>(peakMixNs_) / 1e6,
+                      pacing, lat.samples,
+                      lat.inputToTick.p50, lat.inputToTick.p99, lat.tickToDisplay.p50, lat.tickToDisplay.p99,
+                      lat.inputToDisplay.p50, lat.inputToDisplay.p99);
+        peakStolen_ = 0;
+        peakDropped_ = 0;
+        peakMixNs_ = 0;
+        statsOverlay_->refresh(buf);
     }
-    if (livesText_) {
-        float lh = livesText_->getGlobalBounds().size.y;
-        livesText_->setPosition(sf::Vector2f(MARGIN_.x + 8.f, static_cast<float>(curSize.y) - MARGIN_.y - lh - 8.f));
-        window_.draw(*livesText_);
-    }
-    if (paused_ && !pausedForResult_) {
-        sf::RectangleShape overlay(sf::Vector2f(static_cast<float>(curSize.x), static_cast<float>(curSize.y)));
-        overlay.setFillColor(sf::Color(0,0,0,160));
-        window_.draw(overlay);
-        if (pauseMenu_) pauseMenu_->draw(window_);
-    }
-    if (pausedForResult_) {
-        sf::RectangleShape overlay(sf::Vector2f(static_cast<float>(curSize.x), static_cast<float>(curSize.y)));
-        overlay.setFillColor(sf::Color(0,0,0,160));
-        window_.draw(overlay);
-        if (overlayTitle_ && overlaySub_) {
-            sf::FloatRect rt = overlayTitle_->getLocalBounds();
-            float ox = rt.position.x + rt.size.x * 0.5f;
-            float oy = rt.position.y + rt.size.y * 0.5f;
-            overlayTitle_->setOrigin(sf::Vector2f(ox, oy));
-            overlayTitle_->setPosition(sf::Vector2f(static_cast<float>(curSize.x)/2.f, static_cast<float>(curSize.y)/2.f - 24.f));
-            sf::FloatRect rs = overlaySub_->getLocalBounds();
-            float sox = rs.position.x + rs.size.x * 0.5f;
-            float soy = rs.position.y + rs.size.y * 0.5f;
-            overlaySub_->setOrigin(sf::Vector2f(sox, soy));
-            overlaySub_->setPosition(sf::Vector2f(static_cast<float>(curSize.x)/2.f, static_cast<float>(curSize.y)/2.f + 40.f));
-            window_.draw(*overlayTitle_);
-            window_.draw(*overlaySub_);
+    if (!statsOverlay_->visible()) return;
+    window_.setView(window_.getDefaultView());
+    statsOverlay_->draw(window_);
+}
+
+// Barrido de estrés: para cada tamaño, una partida nueva jugada por el bot a un tick por frame
+// (la carga no depende de lo rápido que vaya el frame), sin vsync. Se mide tick, render (armar y
+// enviar los lotes) y present (display: aquí aflora el trabajo pendiente de la GPU), más la memoria.
+void Game::runStress() {
+    pacer_->configure(window_, PacingMode::Uncapped, pacingHz_);
+    bgMusic_.stop();
+    const ShieldMask shieldShape = sim_->shieldShape();
+    const float frameBudgetMs = 1000.f / 60.f;
+    const float tickBudgetMs = tickDt_ * 1000.f;
+
+    std::ofstream csv;
+    if (!stressCsvPath_.empty()) {
+        csv.open(stressCsvPath_, std::ios::trunc);
+        if (!csv) std::cerr << "[WARN] could not write " << stressCsvPath_ << "\n";
+        else csv << "enemies,cols,rows,fire_rate,shields,bullets_peak,enemies_alive_mean,tick_p50_ms,tick_p99_ms,render_p50_ms,render_p99_ms,"
+                    "present_p50_ms,draw_calls,vertices,particles_peak,sim_bytes,rss_bytes,failed_acquires\n";
+    }
+    std::printf("stress sweep: %d sizes x %d frames, tick %.2f ms, frame budget %.2f ms\n", stressSteps_, stressFrames_, tickBudgetMs, frameBudgetMs);
+    std::printf("%8s %9s %6s %8s %15s %17s %8s %6s %9s %9s %9s %8s\n",
+                "enemies", "fire rate", "shield", "bullets", "tick p50/p99", "render p50/p99", "present", "draws", "vertices", "particles", "sim KB", "rss MB");
+
+    std::vector<float> tickMs, renderMs, presentMs;
+    tickMs.reserve(static_cast<std::size_t>(stressFrames_));
+    renderMs.reserve(static_cast<std::size_t>(stressFrames_));
+    presentMs.reserve(static_cast<std::size_t>(stressFrames_));
+    for (int s = 0; s < stressSteps_ && window_.isOpen(); ++s) {
+        // el doble de enemigos por paso: cada lado de la formación crece en raíz de 2
+        const float k = std::ldexp(1.f, s);
+        SimConfig cfg = simConfig_;
+        cfg.margin = MARGIN_;
+        cfg.enemyCols = std::max(1, static_cast<int>(std::lround(cfg.enemyCols * std::sqrt(k))));
+        cfg.enemyRows = std::max(1, static_cast<int>(std::lround(cfg.enemyRows * std::sqrt(k))));
+        cfg.playerBullets = static_cast<int>(cfg.playerBullets * k);
+        cfg.enemyBullets = static_cast<int>(cfg.enemyBullets * k);
+        cfg.playerBulletLimit = std::max(cfg.playerBulletLimit, cfg.playerBullets);
+        cfg.enemyBulletLimit = std::max(cfg.enemyBulletLimit, cfg.enemyBullets);
+        cfg.enemyFireRate *= k;
+        cfg.shootCooldown /= k;
+        sim_ = std::make_unique<GameSim>(cfg, seed_);
+        sim_->setShieldShape(shieldShape);
+        entityRenderer_->configure(sim_->config());
+        SimPolicy bot(PolicyKind::Bot, seed_);
+        RenderSnapshot snap; // nueva por tamaño: la revisión de escudos vuelve a empezar con cada GameSim
+        particles_->clear();
+
+        tickMs.clear();
+        renderMs.clear();
+        presentMs.clear();
+        std::size_t bulletsPeak = 0;
+        std::size_t particlesPeak = 0;
+        double aliveSum = 0.0;
+        for (int f = 0; f < STRESS_WARMUP_FRAMES + stressFrames_ && window_.isOpen(); ++f) {
+            while (auto ev = window_.pollEvent()) {
+                if (ev->is<sf::Event::Closed>()) window_.close();
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            sim_->step(bot.next(*sim_), tickDt_);
+            if (sim_->isOver()) sim_->reset();
+            const auto t1 = std::chrono::steady_clock::now();
+            // las partículas cuentan como render: salen de los eventos del tick, como en la partida
+            for (const SimEvent& ev : sim_->events()) emitParticles(ev, sim_->shields());
+            particles_->update(tickDt_);
+            window_.clear(sf::Color(18,18,28));
+            window_.setView(gameView_);
+            snap.capture(*sim_);
+            entityRenderer_->draw(window_, snap, 1.f);
+            particles_->draw(window_);
+            const auto t2 = std::chrono::steady_clock::now();
+            window_.display();
+            const auto t3 = std::chrono::steady_clock::now();
+            if (f < STRESS_WARMUP_FRAMES) continue;
+            tickMs.push_back(msSince(t0, t1));
+            renderMs.push_back(msSince(t1, t2));
+            presentMs.push_back(msSince(t2, t3));
+            bulletsPeak = std::max(bulletsPeak, sim_->bullets().active().size() + sim_->enemyBullets().active().size());
+            aliveSum += sim_->formation() ? sim_->formation()->aliveCount() : 0;
+            particlesPeak = std::max(particlesPeak, particles_->size());
+        }
+        if (tickMs.empty()) break;
+
+        const int enemies = sim_->config().enemyCols * sim_->config().enemyRows;
+        const float tick50 = percentile(tickMs.begin(), tickMs.end(), 0.50), tick99 = percentile(tickMs.begin(), tickMs.end(), 0.99);
+        const float render50 = percentile(renderMs.begin(), renderMs.end(), 0.50), render99 = percentile(renderMs.begin(), renderMs.end(), 0.99);
+        const float present50 = percentile(presentMs.begin(), presentMs.end(), 0.50);
+        const SpriteBatch::Stats& rs = entityRenderer_->stats();
+        const std::size_t simBytes = sim_->memoryBytes();
+        const std::size_t rss = Profiler::residentBytes();
+        const std::uint64_t failed = sim_->bullets().stats().failedAcquires + sim_->enemyBullets().stats().failedAcquires;
+        // dónde se cae: la simulación ya no cabe en su paso fijo, o el frame entero pasa de 60 Hz
+        const char* verdict = tick99 > tickBudgetMs ? "  << tick over budget"
+                            : tick50 + render50 + present50 > frameBudgetMs ? "  << frame over 60 Hz" : "";
+        std::printf("%8d %9.1f %6zu %8zu %7.3f/%-7.3f %8.3f/%-8.3f %8.3f %6zu %9zu %9zu %9.1f %8.1f%s\n",
+                    enemies, cfg.enemyFireRate, sim_->shields().size(), bulletsPeak, tick50, tick99, render50, render99, present50,
+                    rs.drawCalls, rs.vertices, particlesPeak, static_cast<double>(simBytes) / 1024.0, static_cast<double>(rss) / (1024.0 * 1024.0), verdict);
+        std::fflush(stdout);
+        if (csv.is_open()) {
+            csv << enemies << ',' << sim_->config().enemyCols << ',' << sim_->config().enemyRows << ',' << cfg.enemyFireRate << ','
+                << sim_->shields().size() << ',' << bulletsPeak << ',' << aliveSum / static_cast<double>(tickMs.size()) << ','
+                << tick50 << ',' << tick99 << ',' << render50 << ',' << render99 << ',' << present50 << ','
+                << rs.drawCalls << ',' << rs.vertices << ',' << particlesPeak << ',' << simBytes << ',' << rss << ',' << failed << '\n';
         }
     }
-    window_.display();
+    window_.close();
 }
 
 void Game::run() {
     while (window_.isOpen()) {
-        handleEvents();
+        if (stressSteps_ > 0 && state_ != AppState::Loading) {
+            runStress();
+            break;
+        }
+        if (allocCheck_) beginFrameAllocs();
+        PROFILE_ZONE("frame");
+        {
+            PROFILE_ZONE("handleEvents");
+            handleEvents();
+        }
         float dt = clock_.restart().asSeconds();
-        update(dt);
-        render();
+        {
+            PROFILE_ZONE("update");
+            update(dt);
+        }
+        {
+            PROFILE_ZONE("render");
+            render();
+            drawStats(dt);
+            if (renderStallMs_ > 0.f) sf::sleep(sf::microseconds(static_cast<std::int64_t>(renderStallMs_ * 1000.f)));
+        }
+        {
+            PROFILE_ZONE("display");
+            window_.display();
+            // este frame ya dibujó los ticks que aplicaron las pulsaciones pendientes
+            latency_->displayed(actionClockNs());
+        }
+        {
+            PROFILE_ZONE("pacing");
+            pacer_->wait();
+        }
+        if (allocCheck_) checkFrameAllocs();
+        if (exitCountdown_ > 0 && --exitCountdown_ == 0) window_.close();
+        if (!interactiveLogged_ && state_ != AppState::Loading) {
+            interactiveLogged_ = true;
+            std::cerr << "[INFO] time to interactive: " << startupClock_.getElapsedTime().asMilliseconds() << " ms\n";
+        }
+    }
+    const LatencyProbe::Summary lat = latency_->summarize();
+    if (lat.total > 0) {
+        std::cerr << "[INFO] input latency over the last " << lat.samples << " of " << lat.total << " presses (" << FramePacer::name(pacer_->mode())
+                  << "): input>tick p50 " << lat.inputToTick.p50 << " ms, tick>display p50 " << lat.tickToDisplay.p50
+                  << " ms, total p50 " << lat.inputToDisplay.p50 << " / p95 " << lat.inputToDisplay.p95 << " / p99 " << lat.inputToDisplay.p99 << " ms\n";
+    }
+    if (allocCheck_) {
+        if (allocFailedFrames_ > 0) std::cerr << "[WARN] alloc check: " << allocFailedFrames_ << " of " << allocCheckedFrames_ << " steady frames allocated\n";
+        else std::cerr << "[INFO] alloc check: " << allocCheckedFrames_ << " steady frames, none allocated\n";
     }
-}
\ No newline at end of file
+    ReplayRecorder* recorder = recorder_.get();
+    if (simThread_) {
+        simThread_->stop();
+        const SimThread::Frame& frame = simThread_->latest();
+        const SimThread::TickStats& ts = frame.stats;
+        if (frame.ticks > 0) {
+            std::cerr << "[INFO] sim thread: " << frame.ticks << " ticks at " << ts.hz << " Hz, interval p50 " << ts.intervalP50 << " / p99 " << ts.intervalP99
+                      << " / max " << ts.intervalMax << " ms, late p99 " << ts.lateP99 << " / max " << ts.lateMax << " ms, " << ts.dropped << " dropped\n";
+        }
+        if (simThread_->droppedEvents() > 0) std::cerr << "[WARN] " << simThread_->droppedEvents() << " sim events dropped (queue full)\n";
+        recorder = simThread_->recorder();
+    }
+    if (recorder) {
+        if (recorder->save(recordPath_)) std::cerr << "[INFO] recorded " << recorder->ticks() << " ticks to " << recordPath_ << "\n";
+        else std::cerr << "[WARN] could not write " << recordPath_ << "\n";
+    }
+}
@@ -0,0 +1,617 @@
+#include "GameSim.h"
+#include "Formation.h"
+#include "Player.h"
+#include "BulletPool.h"
+#include "Shield.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+namespace {
+
+// hueco entre enemigos, en celdas
+constexpr float FORMATION_SPACING_X = 1.65f;
+constexpr float FORMATION_SPACING_Y = 1.15f;
+constexpr float SHIELD_GAP = 12.f;
+
+// fracción del paso (0..1) a la que dos cajas en movimiento rectilíneo empiezan a tocarse, o -1.
+// offset: centro de a menos el de b al empezar; motion: desplazamiento de a menos el de b;
+// reach: suma de las semiextensiones. Si se tocan al final del paso, siempre encuentra el contacto
+float sweepBoxes(sf::Vector2f offset, sf::Vector2f motion, sf::Vector2f reach) {
+    float enter = 0.f;
+    float exit = 1.f;
+    auto axis = [&](float o, float d, float r) {
+        if (d == 0.f) {
+            if (std::abs(o) > r) exit = -1.f;
+            return;
+        }
+        float t0 = (-r - o) / d;
+        float t1 = (r - o) / d;
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+    };
+    axis(offset.x, motion.x, reach.x);
+    axis(offset.y, motion.y, reach.y);
+    return enter <= exit ? enter : -1.f;
+}
+
+}
+
+bool applySimFlag(SimConfig& config, std::string_view flag, const char* value) {
+    auto count = [&](int lo, int hi) { return std::clamp(std::atoi(value), lo, hi); };
+    if (flag == "--cols") config.enemyCols = count(1, 4096);
+    else if (flag == "--rows") config.enemyRows = count(1, 4096);
+    else if (flag == "--shields") config.shieldCount = count(0, 1024);
+    else if (flag == "--fire-rate") config.enemyFireRate = std::clamp(std::strtof(value, nullptr), 0.01f, 10000.f);
+    else if (flag == "--shoot-cooldown") config.shootCooldown = std::max(0.f, std::strtof(value, nullptr));
+    else if (flag == "--player-bullets") {
+        // la capacidad se reserva entera al empezar: el pool ya no crece a mitad de una medida
+        config.playerBullets = count(1, 1 << 20);
+        config.playerBulletLimit = std::max(config.playerBulletLimit, config.playerBullets);
+    } else if (flag == "--enemy-bullets") {
+        config.enemyBullets = count(1, 1 << 20);
+        config.enemyBulletLimit = std::max(config.enemyBulletLimit, config.enemyBullets);
+    } else return false;
+    return true;
+}
+
+GameSim::GameSim(const SimConfig& config, std::uint32_t seed)
+: config_(config)
+, rng_(seed)
+{
+    fitFormation();
+    const float cell = static_cast<float>(config_.cellSize);
+    playerStart_ = sf::Vector2f(config_.margin.x + (config_.windowCols * cell) / 2.f,
+                                config_.margin.y + config_.hudHeight + (config_.windowRows * cell) - cell * 1.5f);
+
+    bullets_ = std::make_unique<BulletPool>(static_cast<std::size_t>(config_.playerBullets), config_.playerBulletSize,
+                                            static_cast<std::size_t>(config_.playerBulletLimit));
+    enemyBullets_ = std::make_unique<BulletPool>(static_cast<std::size_t>(config_.enemyBullets), config_.enemyBulletSize,
+                                                 static_cast<std::size_t>(config_.enemyBulletLimit));
+
+    player_ = std::make_unique<Player>(playerStart_, config_.playerSize);
+    const sf::Vector2i shieldPixels{ static_cast<int>(std::lround(config_.shieldSize.x)), static_cast<int>(std::lround(config_.shieldSize.y)) };
+    shieldShape_ = ShieldMask::bunker(shieldPixels);
+    crater_ = ShieldMask::crater(config_.craterRadius);
+
+    const int gridCols = static_cast<int>((config_.virtualWidth() + config_.cellSize - 1) / config_.cellSize);
+    const int gridRows = static_cast<int>((config_.virtualHeight() + config_.cellSize - 1) / config_.cellSize);
+    enemyGrid_ = SpatialGrid({ 0.f, 0.f }, cell, gridCols, gridRows);
+    shieldGrid_ = SpatialGrid({ 0.f, 0.f }, cell, gridCols, gridRows);
+    events_.reserve(EVENT_RESERVE);
+    contacts_.reserve(static_cast<std::size_t>(config_.playerBullets + config_.enemyBullets));
+    eroders_.reserve(static_cast<std::size_t>(std::max(0, config_.enemyCols * config_.enemyRows)));
+    reset();
+}
+
+GameSim::~GameSim() = default;
+
+void GameSim::emit(SimEventType type, const sf::Vector2f& pos, int value) {
+    events_.push_back(SimEvent{ type, pos, value });
+}
+
+// la formación se crea una vez; cada oleada (y cada partida) la rehace sobre los mismos arrays
+void GameSim::startFormation() {
+    float movement = 40.f + (wave_ - 1) * config_.waveSpeedStep;
+    float descend = 18.f + (wave_ - 1) * config_.waveDescendStep;
+    if (formation_) {
+        formation_->restart(movement, descend);
+        return;
+    }
+    const float cell = static_cast<float>(config_.cellSize);
+    const float formationStartX = config_.margin.x + 2.f * cell;
+    const float formationStartY = config_.margin.y + config_.hudHeight + 1.f * cell;
+    const float spacingX = cell * FORMATION_SPACING_X * config_.enemySpacing;
+    const float spacingY = cell * FORMATION_SPACING_Y * config_.enemySpacing;
+    formation_ = std::make_unique<Formation>(
+        config_.enemyCols, config_.enemyRows,
+        sf::Vector2f{ formationStartX, formationStartY },
+        spacingX, spacingY,
+        config_.enemySize,
+        movement, descend, config_.bounceSpeedup
+    );
+}
+
+// formaciones enormes (modo estrés): se encogen, hueco y tamaño a la vez, hasta caber a lo ancho
+// dejando sitio para moverse y en el 40% superior del campo (la 11x5 original cabe sin tocarla)
+void GameSim::fitFormation() {
+    const float cell = static_cast<float>(config_.cellSize);
+    const float needW = (config_.enemyCols - 1) * cell * FORMATION_SPACING_X * config_.enemySpacing + config_.enemySize.x;
+    const float needH = (config_.enemyRows - 1) * cell * FORMATION_SPACING_Y * config_.enemySpacing + config_.enemySize.y;
+    const float availW = (config_.windowCols - 2) * cell;
+    const float availH = config_.windowRows * cell * 0.4f;
+    const float scale = std::min({ 1.f, availW / needW, availH / needH });
+    if (scale >= 1.f) return;
+    config_.enemySpacing *= scale;
+    config_.enemySize *= scale;
+}
+
+float GameSim::nextEnemyShotDelay() {
+    return enemyShootDist_(rng_) / (config_.enemyFireRate * (1.f + config_.waveFireRateStep * (wave_ - 1)));
+}
+
+void GameSim::savePrevious() {
+    player_->savePrevious();
+    bullets_->savePrevious();
+    enemyBullets_->savePrevious();
+    if (formation_) formation_->savePrevious();
+}
+
+// rest: lo que quedaba del trozo tras el último impacto; la oleada nueva ya lo recorre (y su
+// temporizador lo descuenta), así sale en el mismo instante sea cual sea el paso
+void GameSim::spawnNextWave(double rest) {
+    wave_ += 1;
+    bullets_->clear();
+    enemyBullets_->clear();
+    startFormation();
+    formation_->update(rest, config_.margin.x, static_cast<float>(config_.virtualWidth()) - config_.margin.x);
+    enemyShootTimer_ = std::max(0.0, nextEnemyShotDelay() - rest);
+    emit(SimEventType::WaveStarted, {}, wave_);
+}
+
+void GameSim::reset() {
+    wave_ = 1;
+    tick_ = 0;
+    over_ = false;
+    score_ = 0;
+    lives_ = config_.startLives;
+    events_.clear();
+    player_->setPosition(playerStart_);
+    startFormation();
+    bullets_->clear();
+    enemyBullets_->clear();
+    buildShields();
+
+    shootTimer_ = 0.0;
+    enemyShootTimer_ = nextEnemyShotDelay();
+}
+
+void GameSim::setShieldShape(const ShieldMask& shape) {
+    shieldShape_ = shape;
+    buildShields();
+}
+
+// se reescriben en su sitio: un reinicio no vuelve a reservar las máscaras
+void GameSim::buildShields() {
+    float shieldsY = player_->bounds().position.y - 120.f;
+    sf::Vector2f desiredSize = config_.shieldSize;
+    float padding = 48.f;
+    float available = static_cast<float>(config_.virtualWidth()) - 2.f * padding;
+    // los que no caben en una fila suben a otra, hasta donde empieza la zona de la formación
+    const int perRow = std::max(1, static_cast<int>((available + SHIELD_GAP) / (desiredSize.x + SHIELD_GAP)));
+    const float formationBottom = config_.margin.y + config_.hudHeight + config_.cellSize + config_.windowRows * config_.cellSize * 0.4f;
+    const int maxRows = std::max(1, static_cast<int>((shieldsY - formationBottom) / (desiredSize.y + SHIELD_GAP)) + 1);
+    const int count = std::min(config_.shieldCount, perRow * maxRows);
+    float firstCenterX = padding + desiredSize.x * 0.5f;
+    shields_.resize(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        const int row = i / perRow;
+        const int inRow = std::min(perRow, count - row * perRow);
+        float totalW = static_cast<float>(inRow) * desiredSize.x;
+        float gapBetween = 0.f;
+        if (inRow > 1 && available > totalW) gapBetween = (available - totalW) / static_cast<float>(inRow - 1) + desiredSize.x;
+        else gapBetween = desiredSize.x + SHIELD_GAP;
+        float centerX = firstCenterX + static_cast<float>(i % perRow) * gapBetween;
+        float y = shieldsY - static_cast<float>(row) * (desiredSize.y + SHIELD_GAP);
+        shields_[static_cast<std::size_t>(i)].reset(sf::Vector2f{ centerX - desiredSize.x / 2.f, y }, shieldShape_);
+    }
+    // los escudos no se mueven: su rejilla solo se rehace al reiniciar
+    shieldGrid_.begin(shields_.size());
+    for (std::size_t i = 0; i < shields_.size(); ++i) shieldGrid_.insert(static_cast<std::uint32_t>(i), shields_[i].bounds());
+    shieldGrid_.finish();
+    ++shieldRevision_;
+}
+
+bool GameSim::trySpawnFromColumn(int col) {
+    if (!formation_) return false;
+    const int idx = formation_->bottomAlive(col);
+    if (idx < 0) return false;
+    const EntityArrays& en = formation_->data();
+    sf::Vector2f shotPos{ en.x[idx], en.y[idx] + en.half.y + 4.f };
+    return enemyBullets_->acquire(shotPos, 350.f).valid();
+}
+
+// una sola tirada entre las columnas que aún tienen enemigos
+void GameSim::fireEnemyShot() {
+    const int liveCols = formation_ ? formation_->liveColumnCount() : 0;
+    if (liveCols > 0) {
+        int n = enemyColDist_(rng_, std::uniform_int_distribution<int>::param_type(0, liveCols - 1));
+        trySpawnFromColumn(formation_->nthLiveColumn(n));
+    }
+    enemyShootTimer_ = nextEnemyShotDelay();
+}
+
+void GameSim::firePlayerShot() {
+    sf::FloatRect pb = player_->bounds();
+    sf::Vector2f bulletPos{ pb.position.x + pb.size.x / 2.f, pb.position.y - 6.f };
+    if (bullets_->acquire(bulletPos, -480.f).valid()) {
+        emit(SimEventType::PlayerShot, bulletPos);
+        shootTimer_ += config_.shootCooldown;
+    }
+}
+
+// cada enemigo con todo lo que barrió en el tick, para las pruebas de barrido de las balas
+void GameSim::rebuildEnemyGrid() {
+    const EntityArrays& en = formation_->data();
+    enemyGrid_.begin(en.size());
+    for (std::size_t e = 0; e < en.size(); ++e) {
+        if (en.alive[e]) enemyGrid_.insert(static_cast<std::uint32_t>(e), en.sweptBounds(e));
+    }
+    enemyGrid_.finish();
+}
+
+// índice del primer escudo activo que toca box, o -1
+int GameSim::firstShieldHit(const sf::FloatRect& box) {
+    int hit = -1;
+    shieldGrid_.query(box, [&](std::uint32_t s) {
+        if (!shields_[s].isActive()) return;
+        ++stats_.pairsTested;
+        if ((hit < 0 || static_cast<int>(s) < hit) && shields_[s].overlaps(box)) hit = static_cast<int>(s);
+    });
+    return hit;
+}
+
+// un enemigo se come lo que barrió (swept) de cada escudo que toca (a pasos gruesos pueden ser dos);
+// front: dónde se anuncia
+void GameSim::erodeShields(const sf::FloatRect& swept, sf::Vector2f front) {
+    shieldGrid_.query(swept, [&](std::uint32_t s) {
+        if (!shields_[s].isActive()) return;
+        ++stats_.pairsTested;
+        if (shields_[s].erase(swept)) {
+            ++shieldRevision_;
+            emit(SimEventType::ShieldHit, front, static_cast<int>(s));
+        }
+    });
+}
+
+// lo que el enemigo e se comió desde el inicio del trozo hasta t (0..1)
+void GameSim::erodeUntil(std::size_t e, float t) {
+    const EntityArrays& en = formation_->data();
+    const sf::Vector2f from{ en.prevX[e], en.prevY[e] };
+    const sf::Vector2f to = from + (formation_->position(e) - from) * t;
+    erodeShields(sf::FloatRect({ std::min(from.x, to.x) - en.half.x, std::min(from.y, to.y) - en.half.y },
+                               { std::abs(to.x - from.x) + en.half.x * 2.f, std::abs(to.y - from.y) + en.half.y * 2.f }),
+                 { to.x, to.y + en.half.y });
+}
+
+bool GameSim::rectsIntersect(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return !(a.position.x + a.size.x < b.position.x ||
+             b.position.x + b.size.x < a.position.x ||
+             a.position.y + a.size.y < b.position.y ||
+             b.position.y + b.size.y < a.position.y);
+}
+
+// FNV-1a sobre los bytes del estado; el orden de las balas activas también es determinista
+std::uint64_t GameSim::checksum() const {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const auto& value) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (std::size_t i = 0; i < sizeof(value); ++i) { h ^= bytes[i]; h *= 1099511628211ull; }
+    };
+    mix(tick_); mix(score_); mix(lives_); mix(wave_); mix(over_);
+    mix(shootTimer_); mix(enemyShootTimer_);
+    mix(player_->position().x); mix(player_->position().y);
+    if (formation_) {
+        const EntityArrays& en = formation_->data();
+        for (std::size_t i = 0; i < en.size(); ++i) { mix(en.alive[i]); mix(en.x[i]); mix(en.y[i]); }
+    }
+    for (const BulletPool* pool : { bullets_.get(), enemyBullets_.get() }) {
+        const EntityArrays& b = pool->data();
+        for (std::uint32_t i : pool->active()) { mix(i); mix(b.x[i]); mix(b.y[i]); }
+    }
+    for (const Shield& s : shields_) mix(s.mask().solidCount());
+    return h;
+}
+
+// mismos campos y orden que SimConfig; campo a campo para no mezclar el relleno del struct
+std::uint32_t GameSim::configHash() const {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const auto& value) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (std::size_t i = 0; i < sizeof(value); ++i) { h ^= bytes[i]; h *= 1099511628211ull; }
+    };
+    const SimConfig& c = config_;
+    mix(c.margin.x); mix(c.margin.y);
+    mix(c.windowCols); mix(c.windowRows); mix(c.cellSize); mix(c.hudHeight);
+    mix(c.enemyCols); mix(c.enemyRows);
+    mix(c.playerBullets); mix(c.enemyBullets); mix(c.playerBulletLimit); mix(c.enemyBulletLimit);
+    mix(c.shieldCount); mix(c.craterRadius); mix(c.startLives);
+    mix(c.shootCooldown); mix(c.enemyFireRate); mix(c.enemySpacing);
+    mix(c.waveSpeedStep); mix(c.waveDescendStep); mix(c.bounceSpeedup); mix(c.waveFireRateStep);
+    for (sf::Vector2f v : { c.enemySize, c.playerSize, c.playerBulletSize, c.enemyBulletSize, c.shieldSize }) { mix(v.x); mix(v.y); }
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+std::size_t GameSim::memoryBytes() const {
+    std::size_t bytes = bullets_->memoryBytes() + enemyBullets_->memoryBytes()
+                      + enemyGrid_.memoryBytes() + shieldGrid_.memoryBytes()
+                      + shieldShape_.memoryBytes() + crater_.memoryBytes()
+                      + events_.capacity() * sizeof(SimEvent) + shields_.capacity() * sizeof(Shield);
+    if (formation_) bytes += formation_->memoryBytes();
+    for (const Shield& s : shields_) bytes += s.mask().memoryBytes();
+    return bytes;
+}
+
+void GameSim::step(const SimInput& input, float dt) {
+    PROFILE_ZONE("sim.step");
+    events_.clear();
+    stats_ = SimStats{};
+    if (over_) return;
+    ++tick_;
+
+    // pulsado, lo que sobra del temporizador pasa al siguiente disparo (el ritmo no depende del paso);
+    // suelto, no se acumula. fireAt: cuándo toca disparar dentro del tick (< 0: no toca)
+    const double tickDt = dt;
+    shootTimer_ = std::max(shootTimer_ - tickDt, input.fire ? -tickDt : 0.0);
+    double fireAt = input.fire && shootTimer_ <= 0.0 ? tickDt + shootTimer_ : -1.0;
+
+    // El tick se parte en cada disparo, del jugador o enemigo (con ritmos altos caben varios; lo que
+    // sobra del temporizador pasa al siguiente): qué columna dispara depende de qué enemigos siguen
+    // vivos en ese instante y el jugador dispara desde donde esté entonces (quizá ya de vuelta en la
+    // salida tras un impacto), así que lo anterior se mueve y se resuelve antes. Si no, el resultado
+    // dependería del paso: a pasos gruesos una columna vaciada a mitad de tick seguiría disparando.
+    // También se parte donde la formación toca el borde (el rebote y la bajada ocurren entre dos
+    // trozos, no repartidos a lo largo de uno) y donde el jugador se para en el suyo: las colisiones
+    // suponen que dentro de un trozo todo se mueve en línea recta y a velocidad constante.
+    const float screenRight = static_cast<float>(config_.virtualWidth()) - config_.margin.x;
+    double elapsed = 0.0;
+    for (;;) {
+        const double toPlayer = fireAt >= elapsed ? fireAt - elapsed : tickDt;
+        const double toWall = input.left ? player_->timeToEdge(false) : input.right ? player_->timeToEdge(true) : tickDt;
+        const double toEdge = formation_->timeToEdge(config_.margin.x, screenRight);
+        const double part = std::min({ enemyShootTimer_, toPlayer, toWall, toEdge });
+        if (part > tickDt - elapsed) break;
+        // antes de avanzar: si la oleada se acaba dentro del trozo, la nueva pone el suyo
+        enemyShootTimer_ -= part;
+        if (!advance(input, part)) return;
+        elapsed += part;
+        // la bajada del rebote puede acabar la partida ya, antes que lo que pase en el trozo siguiente
+        if (part == toEdge && formation_->bounceAtEdge(config_.margin.x, screenRight) && !checkInvasion()) return;
+        if (part == toPlayer && fireAt >= 0.0) {
+            firePlayerShot();
+            fireAt = -1.0;
+        }
+        if (enemyShootTimer_ <= 0.0) fireEnemyShot();
+    }
+    enemyShootTimer_ -= tickDt - elapsed;
+    advance(input, tickDt - elapsed);
+}
+
+// un trozo del tick: todo se mueve y se resuelven los impactos; false si la partida terminó
+bool GameSim::advance(const SimInput& input, double dt) {
+    if (dt <= 0.0) return true;
+    savePrevious();
+    playerStep_ = { static_cast<float>((input.left ? -1.0 : input.right ? 1.0 : 0.0) * player_->speed() * dt), 0.f };
+    if (input.left) player_->moveLeft(dt);
+    else if (input.right) player_->moveRight(dt);
+    stepMovement(dt);
+    if (!stepCollisions()) return false;
+
+    PROFILE_ZONE("sim.waveSpawn");
+    if (formation_->aliveCount() == 0) {
+        spawnNextWave(dt * (1.0 - clearedAt_));
+    }
+    return true;
+}
+
+void GameSim::stepMovement(double dt) {
+    PROFILE_ZONE("sim.movement");
+    player_->update(static_cast<float>(dt));
+    bullets_->update(dt);
+    enemyBullets_->update(dt);
+    const float screenRight = static_cast<float>(config_.virtualWidth()) - config_.margin.x;
+    if (formation_) formation_->update(dt, config_.margin.x, screenRight);
+}
+
+// primer escudo que toca una caja que empieza en start y baja dy (sube si es negativo)
+bool GameSim::shieldContact(const sf::FloatRect& start, float dy, Contact& out) {
+    const sf::FloatRect path({ start.position.x, start.position.y + std::min(0.f, dy) }, { start.size.x, start.size.y + std::abs(dy) });
+    bool found = false;
+    shieldGrid_.query(path, [&](std::uint32_t s) {
+        if (!shields_[s].isActive()) return;
+        ++stats_.pairsTested;
+        const std::optional<float> t = shields_[s].sweep(start, dy);
+        // a igual tiempo, el de menor índice
+        if (!t || (found && (*t > out.t || (*t == out.t && s > out.index)))) return;
+        found = true;
+        out.t = *t;
+        out.target = Contact::Target::Shield;
+        out.index = s;
+        out.stamp = shields_[s].mask().solidCount();
+    });
+    return found;
+}
+
+// el movimiento de la bala y el de cada enemigo en el tick se prueban a la vez (movimiento relativo)
+bool GameSim::playerShotContact(std::uint32_t i, Contact& out) {
+    const EntityArrays& pb = bullets_->data();
+    const EntityArrays& en = formation_->data();
+    const sf::Vector2f motion{ pb.x[i] - pb.prevX[i], pb.y[i] - pb.prevY[i] };
+    const sf::Vector2f reach{ pb.half.x + en.half.x, pb.half.y + en.half.y };
+    bool found = shieldContact(pb.previousBounds(i), motion.y, out);
+    enemyGrid_.query(pb.sweptBounds(i), [&](std::uint32_t e) {
+        if (!en.alive[e]) return;
+        ++stats_.pairsTested;
+        const float t = sweepBoxes({ pb.prevX[i] - en.prevX[e], pb.prevY[i] - en.prevY[e] },
+                                   { motion.x - (en.x[e] - en.prevX[e]), motion.y - (en.y[e] - en.prevY[e]) }, reach);
+        if (t < 0.f) return;
+        // un escudo a la vez gana (la bala se para en él); entre enemigos, el de menor índice
+        if (found && (t > out.t || (t == out.t && (out.target == Contact::Target::Shield || e > out.index)))) return;
+        found = true;
+        out.t = t;
+        out.target = Contact::Target::Enemy;
+        out.index = e;
+    });
+    out.bullet = i;
+    out.enemyShot = false;
+    return found;
+}
+
+bool GameSim::enemyShotContact(std::uint32_t i, Contact& out) {
+    const EntityArrays& eb = enemyBullets_->data();
+    const sf::Vector2f motion{ eb.x[i] - eb.prevX[i], eb.y[i] - eb.prevY[i] };
+    bool found = shieldContact(eb.previousBounds(i), motion.y, out);
+    const sf::Vector2f prev = player_->previousPosition();
+    const sf::Vector2f now = player_->position();
+    const sf::Vector2f reach = eb.half + player_->bounds().size / 2.f;
+    ++stats_.pairsTested;
+    const float t = sweepBoxes({ eb.prevX[i] - prev.x, eb.prevY[i] - prev.y }, motion - (now - prev), reach);
+    if (t >= 0.f && (!found || t < out.t)) {
+        found = true;
+        out.t = t;
+        out.target = Contact::Target::Player;
+        out.index = 0;
+        out.stamp = lives_;
+    }
+    out.bullet = i;
+    out.enemyShot = true;
+    return found;
+}
+
+// el objetivo cambió desde que se calculó el contacto (muerto, mordido por otra bala, jugador reiniciado)
+bool GameSim::contactStale(const Contact& c) const {
+    switch (c.target) {
+    case Contact::Target::Enemy: return !formation_->isAlive(c.index);
+    case Contact::Target::Shield: return shields_[c.index].mask().solidCount() != c.stamp;
+    case Contact::Target::Player: return lives_ != c.stamp;
+    }
+    return false;
+}
+
+// false si la partida terminó con este impacto
+bool GameSim::applyContact(const Contact& c) {
+    BulletPool& pool = c.enemyShot ? *enemyBullets_ : *bullets_;
+    const EntityArrays& b = pool.data();
+    const std::uint32_t i = c.bullet;
+    // la caja de la bala en el instante del impacto
+    const sf::Vector2f at{ b.prevX[i] + (b.x[i] - b.prevX[i]) * c.t, b.prevY[i] + (b.y[i] - b.prevY[i]) * c.t };
+    const sf::FloatRect box(at - b.half, b.half * 2.f);
+    const sf::FloatRect end = b.bounds(i);
+    bool tunneled = false;
+    switch (c.target) {
+    case Contact::Target::Shield: {
+        tunneled = !shields_[c.index].overlaps(end);
+        // el cráter se abre en la punta: arriba si sube, abajo si baja
+        const sf::Vector2f tip{ at.x, c.enemyShot ? box.position.y + box.size.y : box.position.y };
+        shields_[c.index].carve(crater_, tip);
+        ++shieldRevision_;
+        emit(SimEventType::ShieldHit, tip, static_cast<int>(c.index));
+        pool.release(i);
+        break;
+    }
+    case Contact::Target::Enemy: {
+        const EntityArrays& en = formation_->data();
+        tunneled = std::abs(en.x[c.index] - b.x[i]) > b.half.x + en.half.x || std::abs(en.y[c.index] - b.y[i]) > b.half.y + en.half.y;
+        // hasta el impacto siguió comiéndose los escudos por los que pasaba (a pasos finos lo haría)
+        erodeUntil(c.index, c.t);
+        pool.release(i);
+        formation_->kill(c.index);
+        score_ += 10;
+        // dónde estaba al recibir el impacto, no al final del trozo (que depende del paso)
+        const sf::Vector2f from{ en.prevX[c.index], en.prevY[c.index] };
+        emit(SimEventType::EnemyKilled, from + (formation_->position(c.index) - from) * c.t, score_);
+        break;
+    }
+    case Contact::Target::Player: {
+        const sf::FloatRect playerBounds = player_->bounds();
+        tunneled = !rectsIntersect(end, playerBounds);
+        pool.release(i);
+        lives_ -= 1;
+        // como con los enemigos: dónde estaba en el instante del impacto
+        const sf::Vector2f prev = player_->previousPosition();
+        const sf::Vector2f hitAt = prev + (player_->position() - prev) * c.t;
+        emit(SimEventType::PlayerHit, hitAt, lives_);
+        if (lives_ <= 0) {
+            over_ = true;
+            emit(SimEventType::GameOver, hitAt - playerBounds.size / 2.f, score_);
+            return false;
+        }
+        // vuelve a la salida en el instante del impacto y hace lo que le quedaba de movimiento en el
+        // trozo (si no, a pasos gruesos perdería más recorrido que a pasos finos). El que pedía la
+        // entrada, no el que hizo: pegado a un borde no se movía, pero en la salida sí se mueve
+        player_->setPosition(playerStart_ + playerStep_ * (1.f - c.t), playerStart_ - playerStep_ * c.t);
+        break;
+    }
+    }
+    if (tunneled) ++stats_.sweptHits;
+    return true;
+}
+
+// Barrido: cada bala se prueba con todo lo que recorrió en el tick (y los enemigos y el jugador con
+// lo suyo), así que a pasos grandes no atraviesa ni un enemigo ni un escudo delgado. Los impactos se
+// resuelven por tiempo de impacto: el que ocurre antes dentro del tick, primero.
+// false si la partida terminó durante las colisiones
+bool GameSim::stepCollisions() {
+    PROFILE_ZONE("sim.collisions");
+    const EntityArrays& en = formation_->data();
+    const std::size_t enemyCount = en.size();
+    if (!bullets_->active().empty()) rebuildEnemyGrid();
+
+    // los que bajan por los escudos: cada impacto en un escudo ve lo que ya se comieron hasta entonces
+    eroders_.clear();
+    for (std::size_t e = 0; e < enemyCount; ++e)
+        if (en.alive[e] && firstShieldHit(en.sweptBounds(e)) >= 0) eroders_.push_back(static_cast<std::uint32_t>(e));
+
+    clearedAt_ = 1.f;
+    contacts_.clear();
+    Contact c;
+    for (std::uint32_t i : bullets_->active())
+        if (playerShotContact(i, c)) contacts_.push_back(c);
+    for (std::uint32_t i : enemyBullets_->active())
+        if (enemyShotContact(i, c)) contacts_.push_back(c);
+    // montículo de mínimos por t; empates resueltos siempre igual
+    const auto later = [](const Contact& a, const Contact& b) {
+        if (a.t != b.t) return a.t > b.t;
+        if (a.enemyShot != b.enemyShot) return a.enemyShot;
+        return a.bullet > b.bullet;
+    };
+    std::make_heap(contacts_.begin(), contacts_.end(), later);
+    while (!contacts_.empty()) {
+        std::pop_heap(contacts_.begin(), contacts_.end(), later);
+        const Contact next = contacts_.back();
+        contacts_.pop_back();
+        if (next.target == Contact::Target::Shield)
+            for (std::uint32_t e : eroders_)
+                if (en.alive[e]) erodeUntil(e, next.t);
+        if (contactStale(next)) {
+            // lo que tenía delante ya no está (o el jugador volvió a la salida): la bala sigue su camino
+            // y puede dar en otra cosa, nunca antes de lo que ya ha pasado
+            const bool found = next.enemyShot ? enemyShotContact(next.bullet, c) : playerShotContact(next.bullet, c);
+            if (found) {
+                c.t = std::max(c.t, next.t);
+                contacts_.push_back(c);
+                std::push_heap(contacts_.begin(), contacts_.end(), later);
+            }
+            continue;
+        }
+        if (!applyContact(next)) return false;
+        if (next.target == Contact::Target::Enemy && formation_->aliveCount() == 0) {
+            // oleada limpia: sus balas desaparecen ya, lo que fuesen a tocar después no cuenta
+            clearedAt_ = next.t;
+            break;
+        }
+    }
+
+    // un enemigo que baja hasta los escudos se los va comiendo: todo lo que barrió en el tick
+    for (std::uint32_t e : eroders_)
+        if (en.alive[e]) erodeShields(en.sweptBounds(e), { en.x[e], en.y[e] + en.half.y });
+    return checkInvasion();
+}
+
+// false (y fin de la partida) si algún enemigo llegó a la altura del jugador
+bool GameSim::checkInvasion() {
+    const EntityArrays& en = formation_->data();
+    const float dangerY = playerStart_.y - config_.cellSize * 0.5f;
+    for (std::size_t e = 0; e < en.size(); ++e) {
+        if (en.alive[e] && en.y[e] + en.half.y >= dangerY) {
+            over_ = true;
+            emit(SimEventType::GameOver, en.bounds(e).position, score_);
+            return false;
+        }
+    }
+    return true;
+}
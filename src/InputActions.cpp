@@ -0,0 +1,55 @@
+#include "InputActions.h"
+#include <chrono>
+
+namespace {
+
+const char* const ACTION_NAMES[ACTION_COUNT] = { "left", "right", "fire", "pause", "confirm", "up", "down", "stats", "trace", "pacing" };
+
+}
+
+std::optional<Action> parseAction(std::string_view name) {
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i)
+        if (name == ACTION_NAMES[i]) return static_cast<Action>(i);
+    return std::nullopt;
+}
+
+const char* actionName(Action a) {
+    const auto i = static_cast<std::size_t>(a);
+    return i < ACTION_COUNT ? ACTION_NAMES[i] : "?";
+}
+
+std::uint64_t actionClockNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    // +1: el 0 queda para "ya vencido"
+    return 1 + static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+void ActionRing::push(const ActionEvent& ev) {
+    if (count_ == CAPACITY) { pop(); ++overflowed_; }
+    events_[(head_ + count_) % CAPACITY] = ev;
+    ++count_;
+}
+
+void ActionRing::pop() {
+    if (count_ == 0) return;
+    head_ = (head_ + 1) % CAPACITY;
+    --count_;
+}
+
+void ActionState::apply(Action a, bool pressed) {
+    if (!isGameplayAction(a)) return;
+    const auto i = static_cast<std::size_t>(a);
+    held_[i] = pressed;
+    if (pressed) tapped_[i] = true;
+}
+
+SimInput ActionState::takeTick() {
+    auto on = [&](Action a) { const auto i = static_cast<std::size_t>(a); return held_[i] || tapped_[i]; };
+    SimInput in;
+    in.left = on(Action::Left);
+    in.right = !in.left && on(Action::Right);
+    in.fire = on(Action::Fire);
+    tapped_ = {};
+    return in;
+}
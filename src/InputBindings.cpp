@@ -0,0 +1,108 @@
+#include "InputBindings.h"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+using Key = sf::Keyboard::Key;
+
+struct NamedKey {
+    const char* name;
+    Key key;
+};
+
+// las que no salen de los rangos contiguos A..Z, Num0..Num9 y F1..F15
+const NamedKey NAMED_KEYS[] = {
+    { "Escape", Key::Escape }, { "Space", Key::Space }, { "Enter", Key::Enter }, { "Backspace", Key::Backspace },
+    { "Tab", Key::Tab }, { "Left", Key::Left }, { "Right", Key::Right }, { "Up", Key::Up }, { "Down", Key::Down },
+    { "LControl", Key::LControl }, { "RControl", Key::RControl }, { "LShift", Key::LShift }, { "RShift", Key::RShift },
+    { "LAlt", Key::LAlt }, { "RAlt", Key::RAlt }, { "Comma", Key::Comma }, { "Period", Key::Period },
+    { "Slash", Key::Slash }, { "Semicolon", Key::Semicolon }, { "Pause", Key::Pause },
+};
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+}
+
+InputBindings::InputBindings() {
+    bind(Key::Left, Action::Left);
+    bind(Key::A, Action::Left);
+    bind(Key::Right, Action::Right);
+    bind(Key::D, Action::Right);
+    bind(Key::Space, Action::Fire);
+    bind(Key::Escape, Action::Pause);
+    bind(Key::Enter, Action::Confirm);
+    bind(Key::Space, Action::Confirm);
+    bind(Key::Up, Action::MenuUp);
+    bind(Key::Down, Action::MenuDown);
+    bind(Key::F3, Action::ToggleStats);
+    bind(Key::F4, Action::WriteTrace);
+    bind(Key::F5, Action::CyclePacing);
+}
+
+void InputBindings::bind(Key key, Action action) {
+    const int k = static_cast<int>(key);
+    if (k < 0 || k >= sf::Keyboard::KeyCount) return;
+    masks_[static_cast<std::size_t>(k)] |= 1u << static_cast<unsigned>(action);
+}
+
+void InputBindings::unbindAll(Action action) {
+    for (std::uint32_t& m : masks_) m &= ~(1u << static_cast<unsigned>(action));
+}
+
+std::uint32_t InputBindings::actions(Key key) const {
+    const int k = static_cast<int>(key);
+    return (k < 0 || k >= sf::Keyboard::KeyCount) ? 0u : masks_[static_cast<std::size_t>(k)];
+}
+
+bool InputBindings::isHeld(Action action) const {
+    const std::uint32_t bit = 1u << static_cast<unsigned>(action);
+    for (std::size_t k = 0; k < masks_.size(); ++k)
+        if ((masks_[k] & bit) && sf::Keyboard::isKeyPressed(static_cast<Key>(k))) return true;
+    return false;
+}
+
+std::optional<Key> InputBindings::parseKey(std::string_view name) {
+    auto offset = [](Key first, int i) { return static_cast<Key>(static_cast<int>(first) + i); };
+    if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z') return offset(Key::A, name[0] - 'A');
+    if (name.size() == 4 && name.substr(0, 3) == "Num" && name[3] >= '0' && name[3] <= '9') return offset(Key::Num0, name[3] - '0');
+    if (name.size() >= 2 && name[0] == 'F') {
+        int n = 0;
+        for (char c : name.substr(1)) n = std::isdigit(static_cast<unsigned char>(c)) ? n * 10 + (c - '0') : -1000;
+        if (n >= 1 && n <= 15) return offset(Key::F1, n - 1);
+    }
+    for (const NamedKey& k : NAMED_KEYS)
+        if (name == k.name) return k.key;
+    return std::nullopt;
+}
+
+bool InputBindings::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::string_view text = line;
+        text = trim(text.substr(0, text.find('#')));
+        if (text.empty()) continue;
+        const std::size_t eq = text.find('=');
+        const std::optional<Action> action = eq == std::string_view::npos ? std::nullopt : parseAction(trim(text.substr(0, eq)));
+        if (!action) { std::cerr << "[WARN] " << path << ":" << lineNo << ": expected 'action = Key, Key'\n"; continue; }
+        unbindAll(*action);
+        std::string_view keys = text.substr(eq + 1);
+        while (!keys.empty()) {
+            const std::size_t comma = keys.find(',');
+            const std::string_view name = trim(keys.substr(0, comma));
+            if (std::optional<Key> key = parseKey(name)) bind(*key, *action);
+            else if (!name.empty()) std::cerr << "[WARN] " << path << ":" << lineNo << ": unknown key '" << name << "'\n";
+            keys = comma == std::string_view::npos ? std::string_view{} : keys.substr(comma + 1);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "LatencyProbe.h"
+#include "Percentile.h"
+#include <algorithm>
+
+namespace {
+
+float nsToMs(std::uint64_t ns) { return static_cast<float>(ns) / 1e6f; }
+
+// tmp: copia de trabajo (nth_element reordena), para no reservar en cada llamada
+template <std::size_t N>
+LatencyProbe::Percentiles percentiles(const std::array<float, N>& samples, std::size_t n, std::array<float, N>& tmp) {
+    LatencyProbe::Percentiles p;
+    if (n == 0) return p;
+    std::copy_n(samples.begin(), n, tmp.begin());
+    const auto end = tmp.begin() + static_cast<std::ptrdiff_t>(n);
+    p.p50 = percentile(tmp.begin(), end, 0.50);
+    p.p95 = percentile(tmp.begin(), end, 0.95);
+    p.p99 = percentile(tmp.begin(), end, 0.99);
+    return p;
+}
+
+}
+
+LatencyProbe::LatencyProbe() {
+    pending_.reserve(PENDING_RESERVE);
+}
+
+void LatencyProbe::consumed(std::uint64_t inputNs, std::uint64_t tickNs) {
+    pending_.push_back(Pending{ inputNs, std::max(inputNs, tickNs) });
+}
+
+void LatencyProbe::displayed(std::uint64_t displayNs) {
+    for (const Pending& p : pending_) {
+        const std::size_t slot = static_cast<std::size_t>(count_ % WINDOW);
+        inputToTick_[slot] = nsToMs(p.tick - p.input);
+        tickToDisplay_[slot] = nsToMs(displayNs - p.tick);
+        inputToDisplay_[slot] = nsToMs(displayNs - p.input);
+        ++count_;
+        if (log_.is_open()) log_ << p.input << ',' << p.tick << ',' << displayNs << '\n';
+    }
+    pending_.clear();
+}
+
+LatencyProbe::Summary LatencyProbe::summarize() const {
+    Summary s;
+    s.total = count_;
+    s.samples = static_cast<std::size_t>(std::min<std::uint64_t>(count_, WINDOW));
+    std::array<float, WINDOW> tmp;
+    s.inputToTick = percentiles(inputToTick_, s.samples, tmp);
+    s.tickToDisplay = percentiles(tickToDisplay_, s.samples, tmp);
+    s.inputToDisplay = percentiles(inputToDisplay_, s.samples, tmp);
+    return s;
+}
+
+bool LatencyProbe::openLog(const std::string& path) {
+    log_.open(path, std::ios::trunc);
+    if (!log_) return false;
+    log_ << "input_ns,tick_ns,display_ns\n";
+    return true;
+}
@@ -0,0 +1,106 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::uint8_t mix(std::uint8_t a, std::uint8_t b, float t) {
+    return static_cast<std::uint8_t>(static_cast<float>(a) + (static_cast<float>(b) - static_cast<float>(a)) * t + 0.5f);
+}
+
+}
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : capacity_(capacity),
+      x_(capacity), y_(capacity), vx_(capacity), vy_(capacity),
+      age_(capacity), ageRate_(capacity), drag_(capacity), gravity_(capacity), size_(capacity),
+      from_(capacity), to_(capacity), vertices_(capacity * 6) {}
+
+void ParticleSystem::emit(const Burst& burst, sf::Vector2f at) {
+    const std::size_t wanted = static_cast<std::size_t>(std::max(0, burst.count));
+    const std::size_t n = std::min(wanted, capacity_ - count_);
+    stats_.dropped += wanted - n;
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t i = count_++;
+        const float a = burst.angle + (unit(rng_) - 0.5f) * burst.spread;
+        const float speed = burst.speedMin + (burst.speedMax - burst.speedMin) * unit(rng_);
+        const float life = burst.lifeMin + (burst.lifeMax - burst.lifeMin) * unit(rng_);
+        x_[i] = at.x;
+        y_[i] = at.y;
+        vx_[i] = std::cos(a) * speed;
+        vy_[i] = std::sin(a) * speed;
+        age_[i] = 0.f;
+        ageRate_[i] = life > 0.f ? 1.f / life : 1e6f;
+        drag_[i] = burst.drag;
+        gravity_[i] = burst.gravity;
+        size_[i] = burst.size;
+        from_[i] = burst.from;
+        to_[i] = burst.to;
+    }
+    stats_.peak = std::max(stats_.peak, count_);
+}
+
+void ParticleSystem::update(float dt) {
+    const std::size_t n = count_;
+    float* x = x_.data();
+    float* y = y_.data();
+    float* vx = vx_.data();
+    float* vy = vy_.data();
+    float* age = age_.data();
+    const float* ageRate = ageRate_.data();
+    const float* drag = drag_.data();
+    const float* gravity = gravity_.data();
+    // sin ramas ni llamadas: se vectoriza tal cual
+    for (std::size_t i = 0; i < n; ++i) {
+        const float damp = std::max(0.f, 1.f - drag[i] * dt);
+        vx[i] *= damp;
+        vy[i] = vy[i] * damp + gravity[i] * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        age[i] += ageRate[i] * dt;
+    }
+    // las muertas se tapan con la última viva; la que llega se comprueba en la misma posición
+    for (std::size_t i = 0; i < count_;) {
+        if (age_[i] >= 1.f) kill(i);
+        else ++i;
+    }
+}
+
+void ParticleSystem::kill(std::size_t i) {
+    const std::size_t last = --count_;
+    if (i == last) return;
+    x_[i] = x_[last];
+    y_[i] = y_[last];
+    vx_[i] = vx_[last];
+    vy_[i] = vy_[last];
+    age_[i] = age_[last];
+    ageRate_[i] = ageRate_[last];
+    drag_[i] = drag_[last];
+    gravity_[i] = gravity_[last];
+    size_[i] = size_[last];
+    from_[i] = from_[last];
+    to_[i] = to_[last];
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target) {
+    if (count_ == 0) return;
+    sf::Vertex* v = vertices_.data();
+    for (std::size_t i = 0; i < count_; ++i, v += 6) {
+        const float t = std::min(age_[i], 1.f);
+        const sf::Color a = from_[i], b = to_[i];
+        const sf::Color c(mix(a.r, b.r, t), mix(a.g, b.g, t), mix(a.b, b.b, t), mix(a.a, b.a, t));
+        const float h = size_[i] * (1.f - 0.5f * t) * 0.5f;
+        const float l = x_[i] - h, r = x_[i] + h;
+        const float top = y_[i] - h, btm = y_[i] + h;
+        // sin textura: coordenadas de textura a cero
+        v[0] = sf::Vertex{ { l, top }, c, {} };
+        v[1] = sf::Vertex{ { r, top }, c, {} };
+        v[2] = sf::Vertex{ { l, btm }, c, {} };
+        v[3] = sf::Vertex{ { l, btm }, c, {} };
+        v[4] = sf::Vertex{ { r, top }, c, {} };
+        v[5] = sf::Vertex{ { r, btm }, c, {} };
+    }
+    // aditiva: donde se amontonan brillan más, y el orden entre ellas no importa
+    target.draw(vertices_.data(), count_ * 6, sf::PrimitiveType::Triangles, sf::RenderStates(sf::BlendAdd));
+}
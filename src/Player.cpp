@@ -1,51 +1,44 @@
 #include "Player.h"
-#include <memory>
+#include <algorithm>
+#include <limits>
 
-static constexpr float TARGET_PLAYER_W = 50.f; // ancho
-static constexpr float TARGET_PLAYER_H = 50.f; // alto
-
-Player::Player(const sf::Texture* texture, const sf::Vector2f& startPos)
+Player::Player(const sf::Vector2f& startPos, const sf::Vector2f& size)
     : position_(startPos)
+    , prevPos_(startPos)
+    , x_(startPos.x)
+    , half_(size / 2.f)
 {
-    if (texture) {
-        sprite_ = std::make_unique<sf::Sprite>(*texture);
-        auto local = sprite_->getLocalBounds();
-
-        float scaleX = TARGET_PLAYER_W / local.size.x;
-        float scaleY = TARGET_PLAYER_H / local.size.y;
-        float scale = std::min(scaleX, scaleY);
-        sprite_->setScale({ scale, scale });
-
-        auto newLocal = sprite_->getLocalBounds();
-        sprite_->setOrigin({ newLocal.size.x / 2.f, newLocal.size.y / 2.f });
-        sprite_->setPosition(position_);
-    }
 }
 
 void Player::update(float /*dt*/) {
-    if (sprite_) sprite_->setPosition(position_);
-    else fallbackRect_.setPosition(position_);
 }
 
-void Player::draw(sf::RenderWindow& window) const {
-    if (sprite_) window.draw(*sprite_);
-    else window.draw(fallbackRect_);
+void Player::savePrevious() { prevPos_ = position_; }
+
+void Player::moveLeft(double dt) {
+    x_ = std::max(static_cast<double>(LEFT_EDGE), x_ - speed_ * dt);
+    position_.x = static_cast<float>(x_);
 }
 
-void Player::moveLeft(float dt) {
-    position_.x -= speed_ * dt;
-    if (position_.x < 16.f) position_.x = 16.f;
+float Player::timeToEdge(bool right) const {
+    const float gap = right ? rightLimit_ - half_.x * 2.f / 3.f - position_.x : position_.x - LEFT_EDGE;
+    return gap > 0.f ? gap / speed_ : std::numeric_limits<float>::infinity();
 }
 
 void Player::setPosition(const sf::Vector2f& pos) {
     position_ = pos;
-    if (sprite_) sprite_->setPosition(position_);
-    else fallbackRect_.setPosition(position_);
+    x_ = pos.x;
+    prevPos_ = pos;
+}
+
+void Player::setPosition(const sf::Vector2f& pos, const sf::Vector2f& previous) {
+    position_ = pos;
+    x_ = pos.x;
+    prevPos_ = previous;
 }
 
 sf::FloatRect Player::bounds() const {
-    if (sprite_) return sprite_->getGlobalBounds();
-    return fallbackRect_.getGlobalBounds();
+    return sf::FloatRect(position_ - half_, half_ * 2.f);
 }
 void Player::setHorizontalLimits(float left, float right) {
     leftLimit_ = left;
@@ -53,14 +46,8 @@ void Player::setHorizontalLimits(float left, float right) {
 }
 
 
-void Player::moveRight(float dt) {
-    position_.x += speed_ * dt;
-    float halfW = 3.f;
-    if (sprite_) {
-        auto gb = sprite_->getGlobalBounds();
-        halfW = gb.size.x / 3.f;
-    } else {
-        halfW = fallbackRect_.getSize().x / 3.f;
-    }
-    if (position_.x > rightLimit_ - halfW) position_.x = rightLimit_ - halfW;
-}
\ No newline at end of file
+void Player::moveRight(double dt) {
+    float halfW = half_.x * 2.f / 3.f;
+    x_ = std::min(static_cast<double>(rightLimit_ - halfW), x_ + speed_ * dt);
+    position_.x = static_cast<float>(x_);
+}
@@ -0,0 +1,189 @@
+#include "Profiler.h"
+#include "Percentile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() = default;
+
+std::uint64_t Profiler::nowNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+std::size_t Profiler::residentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.WorkingSetSize;
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) return info.resident_size;
+    return 0;
+#else
+    // segunda columna de /proc/self/statm: páginas residentes
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::uint32_t Profiler::registerZone(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // el mismo nombre desde dos sitios comparte zona
+    for (std::size_t i = 0; i < zoneCount_; ++i) {
+        if (std::strcmp(zoneNames_[i], name) == 0) return static_cast<std::uint32_t>(i);
+    }
+    // sin sitio: la zona existe pero no se mide
+    if (zoneCount_ == MAX_ZONES) return static_cast<std::uint32_t>(MAX_ZONES);
+    zoneNames_[zoneCount_] = name;
+    return static_cast<std::uint32_t>(zoneCount_++);
+}
+
+// el primer record() de cada hilo toma un buffer (libre o nuevo); al terminar el hilo lo devuelve
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    struct Slot {
+        ThreadBuffer* buffer = nullptr;
+        ~Slot() { if (buffer) buffer->inUse.store(false, std::memory_order_release); }
+    };
+    thread_local Slot slot;
+    if (!slot.buffer) slot.buffer = acquireBuffer();
+    return *slot.buffer;
+}
+
+Profiler::ThreadBuffer* Profiler::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadBuffer* b = nullptr;
+    for (auto& candidate : buffers_) {
+        if (!candidate->inUse.load(std::memory_order_acquire)) { b = candidate.get(); break; }
+    }
+    if (!b) {
+        buffers_.push_back(std::make_unique<ThreadBuffer>());
+        b = buffers_.back().get();
+    }
+    // conserva eventos y muestras del hilo anterior: cada evento lleva su hilo
+    b->tid = threadCount_++;
+    b->inUse.store(true, std::memory_order_relaxed);
+    return b;
+}
+
+void Profiler::record(std::uint32_t zone, std::uint64_t startNs, std::uint64_t durNs, std::uint64_t allocs) {
+    if (zone >= MAX_ZONES) return;
+    ThreadBuffer& b = threadBuffer();
+    const std::uint64_t n = b.written.load(std::memory_order_relaxed);
+    Event& e = b.events[n % THREAD_EVENT_CAPACITY];
+    e.start.store(startNs, std::memory_order_relaxed);
+    e.dur.store(durNs, std::memory_order_relaxed);
+    e.zoneTid.store(zone | (static_cast<std::uint64_t>(b.tid) << 32), std::memory_order_relaxed);
+    b.written.store(n + 1, std::memory_order_release);
+
+    ZoneSamples& z = b.zones[zone];
+    const std::uint64_t count = z.count.load(std::memory_order_relaxed);
+    z.samples[count % ZONE_SAMPLES].store(static_cast<float>(durNs) / 1000.f, std::memory_order_relaxed);
+    z.count.store(count + 1, std::memory_order_release);
+    if (allocs) z.allocs.store(z.allocs.load(std::memory_order_relaxed) + allocs, std::memory_order_relaxed);
+}
+
+void Profiler::allocsByZone(std::vector<std::uint64_t>& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.assign(zoneCount_, 0);
+    for (const auto& b : buffers_)
+        for (std::size_t i = 0; i < zoneCount_; ++i) out[i] += b->zones[i].allocs.load(std::memory_order_relaxed);
+}
+
+const char* Profiler::zoneName(std::uint32_t zone) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return zone < zoneCount_ ? zoneNames_[zone] : "?";
+}
+
+std::vector<Profiler::ZoneSummary> Profiler::summarize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ZoneSummary> out;
+    out.reserve(zoneCount_);
+    std::vector<float> tmp;
+    tmp.reserve(buffers_.size() * ZONE_SAMPLES);
+    for (std::size_t zi = 0; zi < zoneCount_; ++zi) {
+        // las últimas muestras de cada hilo, juntas
+        tmp.clear();
+        std::uint64_t allocs = 0;
+        for (const auto& b : buffers_) {
+            const ZoneSamples& z = b->zones[zi];
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(z.count.load(std::memory_order_acquire), ZONE_SAMPLES));
+            for (std::size_t k = 0; k < n; ++k) tmp.push_back(z.samples[k].load(std::memory_order_relaxed));
+            allocs += z.allocs.load(std::memory_order_relaxed);
+        }
+        if (tmp.empty()) continue;
+        float p50 = percentile(tmp.begin(), tmp.end(), 0.50);
+        float p99 = percentile(tmp.begin(), tmp.end(), 0.99);
+        out.push_back(ZoneSummary{ zoneNames_[zi], p50, p99, tmp.size(), allocs });
+    }
+    return out;
+}
+
+// copia los eventos aún presentes en el buffer de un hilo que puede seguir escribiendo
+void Profiler::copyEvents(const ThreadBuffer& b, std::vector<CopiedEvent>& out) const {
+    const std::uint64_t end = b.written.load(std::memory_order_acquire);
+    const std::uint64_t begin = end > THREAD_EVENT_CAPACITY ? end - THREAD_EVENT_CAPACITY : 0;
+    const std::size_t from = out.size();
+    for (std::uint64_t k = begin; k < end; ++k) {
+        const Event& e = b.events[k % THREAD_EVENT_CAPACITY];
+        const std::uint64_t zt = e.zoneTid.load(std::memory_order_relaxed);
+        out.push_back(CopiedEvent{ static_cast<std::uint32_t>(zt), static_cast<std::uint32_t>(zt >> 32),
+                                   e.start.load(std::memory_order_relaxed), e.dur.load(std::memory_order_relaxed) });
+    }
+    // lo que el dueño haya pisado mientras se copiaba (más un hueco por la escritura en curso) se descarta
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t after = b.written.load(std::memory_order_relaxed);
+    const std::uint64_t valid = after + 1 > THREAD_EVENT_CAPACITY ? after + 1 - THREAD_EVENT_CAPACITY : 0;
+    if (valid > begin) {
+        const std::size_t drop = static_cast<std::size_t>(std::min(valid, end) - begin);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(from), out.begin() + static_cast<std::ptrdiff_t>(from + drop));
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    // se copia con el mutex (solo frena a un hilo que empiece a medir justo ahora) y se escribe sin él
+    std::vector<CopiedEvent> events;
+    std::array<const char*, MAX_ZONES> names{};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names = zoneNames_;
+        for (const auto& b : buffers_) copyEvents(*b, events);
+    }
+    std::sort(events.begin(), events.end(), [](const CopiedEvent& a, const CopiedEvent& b) { return a.start < b.start; });
+
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\"traceEvents\":[\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (std::size_t k = 0; k < events.size(); ++k) {
+        const CopiedEvent& e = events[k];
+        out << (k ? ",\n" : "")
+            << "{\"name\":\"" << (e.zone < MAX_ZONES && names[e.zone] ? names[e.zone] : "?") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+            << ",\"ts\":" << static_cast<double>(e.start) / 1000.0
+            << ",\"dur\":" << static_cast<double>(e.dur) / 1000.0 << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
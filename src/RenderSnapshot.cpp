@@ -0,0 +1,50 @@
+#include "RenderSnapshot.h"
+#include "GameSim.h"
+#include "Formation.h"
+#include "BulletPool.h"
+#include "Player.h"
+
+namespace {
+
+void captureBullets(RenderSnapshot::Sprites& out, const BulletPool& pool) {
+    out.clear();
+    const EntityArrays& arr = pool.data();
+    out.reserve(arr.size());
+    for (std::uint32_t i : pool.active()) out.push(arr.prevX[i], arr.prevY[i], arr.x[i], arr.y[i]);
+}
+
+}
+
+void RenderSnapshot::capture(const GameSim& sim) {
+    enemies.clear();
+    enemyKinds.clear();
+    if (const Formation* f = sim.formation()) {
+        const EntityArrays& en = f->data();
+        enemies.reserve(en.size());
+        enemyKinds.reserve(en.size());
+        for (std::size_t i = 0; i < en.size(); ++i) {
+            if (!en.alive[i]) continue;
+            enemies.push(en.prevX[i], en.prevY[i], en.x[i], en.y[i]);
+            enemyKinds.push_back(f->kind(i));
+        }
+    }
+    captureBullets(playerBullets, sim.bullets());
+    captureBullets(enemyBullets, sim.enemyBullets());
+
+    const Player* p = sim.player();
+    hasPlayer = p != nullptr;
+    if (p) { playerPrev = p->previousPosition(); player = p->position(); }
+
+    // cada copia del triple buffer guarda su revisión: la que se queda atrás se pone al día aquí
+    if (shields.size() != sim.shields().size() || shieldRevision != sim.shieldRevision()) {
+        shields = sim.shields();
+        shieldRevision = sim.shieldRevision();
+    }
+
+    score = sim.score();
+    lives = sim.lives();
+    wave = sim.wave();
+    over = sim.isOver();
+    tick = sim.tick();
+    pairsTested = sim.stats().pairsTested;
+}
@@ -0,0 +1,106 @@
+#include "Replay.h"
+#include <cstring>
+#include <fstream>
+
+void ReplayRecorder::begin(std::uint32_t seed, float dt, std::uint32_t shieldShape, std::uint32_t config) {
+    seed_ = seed;
+    dt_ = dt;
+    shieldShape_ = shieldShape;
+    config_ = config;
+    inputs_.clear();
+    checksums_.clear();
+    actions_.clear();
+}
+
+void ReplayRecorder::record(const SimInput& input, bool resetBefore, const GameSim& sim) {
+    std::uint8_t bits = 0;
+    if (input.left) bits |= REPLAY_LEFT;
+    if (input.right) bits |= REPLAY_RIGHT;
+    if (input.fire) bits |= REPLAY_FIRE;
+    if (resetBefore) bits |= REPLAY_RESET;
+    const std::uint64_t t = checksums_.size();
+    if (t % 2 == 0) inputs_.push_back(bits);
+    else inputs_.back() |= static_cast<std::uint8_t>(bits << 4);
+    checksums_.push_back(foldChecksum(sim.checksum()));
+}
+
+void ReplayRecorder::recordAction(Action action, bool pressed, std::uint8_t subTick) {
+    actions_.push_back(ReplayAction{ static_cast<std::uint32_t>(checksums_.size()), subTick, static_cast<std::uint8_t>(action),
+                                     static_cast<std::uint8_t>(pressed ? 1 : 0), 0 });
+}
+
+bool ReplayRecorder::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    ReplayHeader header{};
+    std::memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    header.version = REPLAY_VERSION;
+    header.seed = seed_;
+    header.dt = dt_;
+    header.ticks = checksums_.size();
+    header.shieldShape = shieldShape_;
+    header.config = config_;
+    header.actions = static_cast<std::uint32_t>(actions_.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(inputs_.data()), static_cast<std::streamsize>(inputs_.size()));
+    out.write(reinterpret_cast<const char*>(checksums_.data()), static_cast<std::streamsize>(checksums_.size() * sizeof(std::uint32_t)));
+    out.write(reinterpret_cast<const char*>(actions_.data()), static_cast<std::streamsize>(actions_.size() * sizeof(ReplayAction)));
+    return static_cast<bool>(out);
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    ReplayHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 || header.version != REPLAY_VERSION || !(header.dt > 0.f)) return false;
+
+    // el tamaño tiene que cuadrar exactamente con el número de ticks de la cabecera
+    in.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<std::uint64_t>(in.tellg());
+    const std::uint64_t inputBytes = (header.ticks + 1) / 2;
+    const std::uint64_t actionBytes = static_cast<std::uint64_t>(header.actions) * sizeof(ReplayAction);
+    if (header.ticks > fileSize || fileSize != sizeof(header) + inputBytes + header.ticks * sizeof(std::uint32_t) + actionBytes) return false;
+    in.seekg(sizeof(header));
+
+    inputs_.resize(static_cast<std::size_t>(inputBytes));
+    checksums_.resize(static_cast<std::size_t>(header.ticks));
+    actions_.resize(header.actions);
+    in.read(reinterpret_cast<char*>(inputs_.data()), static_cast<std::streamsize>(inputs_.size()));
+    in.read(reinterpret_cast<char*>(checksums_.data()), static_cast<std::streamsize>(checksums_.size() * sizeof(std::uint32_t)));
+    in.read(reinterpret_cast<char*>(actions_.data()), static_cast<std::streamsize>(actionBytes));
+    if (!in) return false;
+    for (const ReplayAction& a : actions_)
+        if (a.tick >= header.ticks || a.action >= GAMEPLAY_ACTION_COUNT) return false;
+    seed_ = header.seed;
+    dt_ = header.dt;
+    shieldShape_ = header.shieldShape;
+    config_ = header.config;
+    return true;
+}
+
+SimInput Replay::input(std::uint64_t tick) const {
+    const std::uint8_t b = bits(tick);
+    SimInput in;
+    in.left = (b & REPLAY_LEFT) != 0;
+    in.right = (b & REPLAY_RIGHT) != 0;
+    in.fire = (b & REPLAY_FIRE) != 0;
+    return in;
+}
+
+bool ReplayPlayer::step(GameSim& sim) {
+    return !done() && step(sim, replay_.input(tick_));
+}
+
+bool ReplayPlayer::step(GameSim& sim, const SimInput& input) {
+    if (done()) return false;
+    if (replay_.bits(tick_) & REPLAY_RESET) sim.reset();
+    sim.step(input, replay_.dt());
+    lastChecksum_ = foldChecksum(sim.checksum());
+    if (lastChecksum_ != replay_.checksum(tick_)) {
+        if (!firstDivergence_) firstDivergence_ = tick_;
+        ++divergent_;
+    }
+    ++tick_;
+    return true;
+}
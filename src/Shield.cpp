@@ -1,48 +1,58 @@
 #include "Shield.h"
 #include <algorithm>
-#include <cstdint>
-
-Shield::Shield(const sf::Texture* tex, const sf::Vector2f& position, int hp, const sf::Vector2f& size)
-: tex_(tex), hp_(hp), maxHp_(hp), active_(hp > 0) {
-    if (tex_) sprite_ = std::make_unique<sf::Sprite>(*tex_);
-    if (sprite_) {
-        sprite_->setPosition(position);
-        if (size.x > 0.f || size.y > 0.f) {
-            sf::Vector2u ts = tex_->getSize();
-            float scaleX = 1.f;
-            float scaleY = 1.f;
-            if (ts.x > 0 && size.x > 0.f) scaleX = size.x / static_cast<float>(ts.x);
-            if (ts.y > 0 && size.y > 0.f) scaleY = size.y / static_cast<float>(ts.y);
-            if (size.x > 0.f && size.y == 0.f && ts.y > 0) scaleY = scaleX;
-            if (size.y > 0.f && size.x == 0.f && ts.x > 0) scaleX = scaleY;
-            sprite_->setScale(sf::Vector2f{scaleX, scaleY});
-        }
-    }
-}
-
-void Shield::draw(sf::RenderWindow& window) const {
-    if (!active_) return;
-    if (sprite_) window.draw(*sprite_);
+#include <cmath>
+
+Shield::Shield(const sf::Vector2f& position, const ShieldMask& mask)
+: position_(position), mask_(mask) {
+}
+
+void Shield::reset(const sf::Vector2f& position, const ShieldMask& mask) {
+    position_ = position;
+    mask_ = mask;
 }
 
 sf::FloatRect Shield::bounds() const {
-    if (sprite_) return sprite_->getGlobalBounds();
-    return sf::FloatRect{};
-}
-
-bool Shield::takeDamage(int dmg) {
-    if (!active_) return false;
-    hp_ -= dmg;
-    if (hp_ <= 0) {
-        active_ = false;
-        return true;
-    }
-    float t = static_cast<float>(hp_) / static_cast<float>(std::max(1, maxHp_));
-    uint8_t alpha = static_cast<uint8_t>(std::max(64.0f, 255.0f * t));
-    if (sprite_) sprite_->setColor(sf::Color(255,255,255, alpha));
-    return false;
-}
-
-bool Shield::isActive() const {
-    return active_;
-}
\ No newline at end of file
+    return sf::FloatRect(position_, { static_cast<float>(mask_.width()), static_cast<float>(mask_.height()) });
+}
+
+// píxeles que toca box, sin recortar (lo recorta la máscara). Entrar menos de TOUCH_SLACK en un
+// píxel no cuenta: una bala disparada justo desde el borde del escudo lo rozaría o no según el
+// redondeo (que depende del paso)
+sf::IntRect Shield::toLocal(const sf::FloatRect& box) const {
+    const int x0 = static_cast<int>(std::floor(box.position.x - position_.x + TOUCH_SLACK));
+    const int y0 = static_cast<int>(std::floor(box.position.y - position_.y + TOUCH_SLACK));
+    const int x1 = static_cast<int>(std::ceil(box.position.x + box.size.x - position_.x - TOUCH_SLACK));
+    const int y1 = static_cast<int>(std::ceil(box.position.y + box.size.y - position_.y - TOUCH_SLACK));
+    return sf::IntRect({ x0, y0 }, { x1 - x0, y1 - y0 });
+}
+
+bool Shield::overlaps(const sf::FloatRect& box) const {
+    return mask_.any(toLocal(box));
+}
+
+std::optional<float> Shield::sweep(const sf::FloatRect& box, float dy) const {
+    const sf::FloatRect path({ box.position.x, box.position.y + std::min(0.f, dy) }, { box.size.x, box.size.y + std::abs(dy) });
+    const int row = mask_.firstSolidRow(toLocal(path), dy > 0.f);
+    if (row < 0) return std::nullopt;
+    if (dy == 0.f) return 0.f;
+    // mismo redondeo que toLocal: la caja toca la fila en cuanto su borde delantero entra TOUCH_SLACK en ella
+    const float rowTop = position_.y + static_cast<float>(row);
+    const float t = dy > 0.f ? (rowTop + TOUCH_SLACK - (box.position.y + box.size.y)) / dy
+                             : (box.position.y - (rowTop + 1.f - TOUCH_SLACK)) / -dy;
+    return std::clamp(t, 0.f, 1.f);
+}
+
+bool Shield::carve(const ShieldMask& crater, const sf::Vector2f& center) {
+    // el píxel más cercano: la punta de una bala que choca cae justo en el borde de una fila (y el
+    // jugador suele disparar desde x enteras o medias), y con floor un error de redondeo que depende
+    // del paso movería el cráter un píxel entero. Primero se lleva a 1/1024 px: sin eso, una x media
+    // con ese error redondearía a un lado o al otro
+    const auto nearest = [](float v) { return static_cast<int>(std::lround(std::round(v * 1024.f) / 1024.f)); };
+    const int cx = nearest(center.x - position_.x);
+    const int cy = nearest(center.y - position_.y);
+    return mask_.carve(crater, cx, cy) > 0;
+}
+
+bool Shield::erase(const sf::FloatRect& box) {
+    return mask_.clear(toLocal(box)) > 0;
+}
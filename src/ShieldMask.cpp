@@ -0,0 +1,167 @@
+#include "ShieldMask.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// bits [lo, hi) de una palabra, con 0 <= lo < hi <= 64
+std::uint64_t bitRange(int lo, int hi) {
+    const std::uint64_t upper = hi == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << hi) - 1;
+    return upper & ~((std::uint64_t{1} << lo) - 1);
+}
+
+}
+
+ShieldMask::ShieldMask(int width, int height)
+: width_(std::max(0, width)), height_(std::max(0, height)), wordsPerRow_((width_ + 63) / 64)
+, bits_(static_cast<std::size_t>(wordsPerRow_) * height_, 0)
+{
+}
+
+ShieldMask ShieldMask::fromAlpha(const std::uint8_t* rgba, sf::Vector2u imageSize, sf::Vector2i size, std::uint8_t threshold) {
+    ShieldMask m(size.x, size.y);
+    if (!rgba || imageSize.x == 0 || imageSize.y == 0) return m;
+    for (int y = 0; y < m.height_; ++y) {
+        const std::size_t sy = static_cast<std::size_t>(y) * imageSize.y / m.height_;
+        for (int x = 0; x < m.width_; ++x) {
+            const std::size_t sx = static_cast<std::size_t>(x) * imageSize.x / m.width_;
+            if (rgba[(sy * imageSize.x + sx) * 4 + 3] >= threshold) m.set(x, y);
+        }
+    }
+    m.recount();
+    return m;
+}
+
+std::optional<ShieldMask> ShieldMask::fromImageFile(const std::string& path, sf::Vector2i size) {
+    sf::Image img;
+    if (!img.loadFromFile(path)) return std::nullopt;
+    return fromAlpha(img.getPixelsPtr(), img.getSize(), size);
+}
+
+ShieldMask ShieldMask::bunker(sf::Vector2i size) {
+    ShieldMask m(size.x, size.y);
+    const int chamfer = size.y / 4;
+    const float archRx = size.x * 0.2f;
+    const float archRy = size.y * 0.35f;
+    for (int y = 0; y < m.height_; ++y) {
+        for (int x = 0; x < m.width_; ++x) {
+            if (x + y < chamfer || (m.width_ - 1 - x) + y < chamfer) continue;
+            const float ax = (x + 0.5f - size.x * 0.5f) / archRx;
+            const float ay = (y + 0.5f - static_cast<float>(size.y)) / archRy;
+            if (ax * ax + ay * ay < 1.f) continue;
+            m.set(x, y);
+        }
+    }
+    m.recount();
+    return m;
+}
+
+ShieldMask ShieldMask::crater(int radius) {
+    radius = std::clamp(radius, 1, 31);
+    const int d = radius * 2 + 1;
+    ShieldMask m(d, d);
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            // mordiscos de 0..3 en el borde, fijos por posición: todos los cráteres iguales
+            std::uint32_t h = static_cast<std::uint32_t>(dx) * 73856093u ^ static_cast<std::uint32_t>(dy) * 19349663u;
+            h = (h ^ (h >> 13)) * 0x5bd1e995u;
+            const int bite = static_cast<int>((h >> 28) & 3u);
+            if (dx * dx + dy * dy + bite * radius <= radius * radius) m.set(dx + radius, dy + radius);
+        }
+    }
+    m.recount();
+    return m;
+}
+
+bool ShieldMask::clip(sf::IntRect& rect) const {
+    const int x0 = std::max(0, rect.position.x);
+    const int y0 = std::max(0, rect.position.y);
+    const int x1 = std::min(width_, rect.position.x + rect.size.x);
+    const int y1 = std::min(height_, rect.position.y + rect.size.y);
+    if (x0 >= x1 || y0 >= y1) return false;
+    rect = sf::IntRect({ x0, y0 }, { x1 - x0, y1 - y0 });
+    return true;
+}
+
+int ShieldMask::firstSolidRow(sf::IntRect rect, bool downwards) const {
+    if (!clip(rect)) return -1;
+    const int x1 = rect.position.x + rect.size.x;
+    const int w0 = rect.position.x >> 6;
+    const int w1 = (x1 - 1) >> 6;
+    for (int i = 0; i < rect.size.y; ++i) {
+        const int y = downwards ? rect.position.y + i : rect.position.y + rect.size.y - 1 - i;
+        const std::uint64_t* r = row(y);
+        for (int w = w0; w <= w1; ++w) {
+            const int lo = std::max(rect.position.x, w * 64) - w * 64;
+            const int hi = std::min(x1, w * 64 + 64) - w * 64;
+            if (r[w] & bitRange(lo, hi)) return y;
+        }
+    }
+    return -1;
+}
+
+int ShieldMask::clear(sf::IntRect rect) {
+    if (!clip(rect)) return 0;
+    const int x1 = rect.position.x + rect.size.x;
+    const int w0 = rect.position.x >> 6;
+    const int w1 = (x1 - 1) >> 6;
+    int cleared = 0;
+    for (int y = rect.position.y; y < rect.position.y + rect.size.y; ++y) {
+        std::uint64_t* r = bits_.data() + static_cast<std::size_t>(y) * wordsPerRow_;
+        for (int w = w0; w <= w1; ++w) {
+            const int lo = std::max(rect.position.x, w * 64) - w * 64;
+            const int hi = std::min(x1, w * 64 + 64) - w * 64;
+            const std::uint64_t m = bitRange(lo, hi);
+            cleared += std::popcount(r[w] & m);
+            r[w] &= ~m;
+        }
+    }
+    solid_ -= cleared;
+    return cleared;
+}
+
+int ShieldMask::carve(const ShieldMask& stamp, int cx, int cy) {
+    if (stamp.wordsPerRow_ != 1) return 0;
+    const int x0 = cx - stamp.width_ / 2;
+    const int y0 = cy - stamp.height_ / 2;
+    if (x0 <= -64 || x0 >= width_) return 0;
+    int cleared = 0;
+    for (int sy = 0; sy < stamp.height_; ++sy) {
+        const int y = y0 + sy;
+        if (y < 0 || y >= height_) continue;
+        const std::uint64_t s = stamp.row(sy)[0];
+        std::uint64_t* r = bits_.data() + static_cast<std::size_t>(y) * wordsPerRow_;
+        // la fila del stamp cae como mucho en dos palabras; lo que sobra por la derecha son bits
+        // más allá del ancho, que nunca están puestos
+        auto apply = [&](int w, std::uint64_t part) {
+            if (w < 0 || w >= wordsPerRow_ || !part) return;
+            cleared += std::popcount(r[w] & part);
+            r[w] &= ~part;
+        };
+        if (x0 < 0) {
+            apply(0, s >> -x0);
+        } else {
+            const int shift = x0 & 63;
+            apply(x0 >> 6, s << shift);
+            if (shift) apply((x0 >> 6) + 1, s >> (64 - shift));
+        }
+    }
+    solid_ -= cleared;
+    return cleared;
+}
+
+std::uint32_t ShieldMask::hash() const {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) { h ^= (v >> (i * 8)) & 0xFFu; h *= 1099511628211ull; }
+    };
+    mix(static_cast<std::uint64_t>(width_));
+    mix(static_cast<std::uint64_t>(height_));
+    for (std::uint64_t w : bits_) mix(w);
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+void ShieldMask::recount() {
+    solid_ = 0;
+    for (std::uint64_t w : bits_) solid_ += std::popcount(w);
+}
@@ -0,0 +1,68 @@
+#include "SimPolicy.h"
+#include "Formation.h"
+#include "Player.h"
+#include "Replay.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// dispara siempre y se coloca bajo el enemigo vivo más cercano en horizontal
+SimInput botInput(const GameSim& sim) {
+    SimInput in;
+    in.fire = true;
+    const Player* player = sim.player();
+    const Formation* formation = sim.formation();
+    if (!player || !formation) return in;
+    float px = player->position().x;
+    float bestDist = std::numeric_limits<float>::max();
+    float targetX = px;
+    const EntityArrays& en = formation->data();
+    for (std::size_t i = 0; i < en.size(); ++i) {
+        if (!en.alive[i]) continue;
+        float d = std::abs(en.x[i] - px);
+        if (d < bestDist) { bestDist = d; targetX = en.x[i]; }
+    }
+    if (targetX < px - 4.f) in.left = true;
+    else if (targetX > px + 4.f) in.right = true;
+    return in;
+}
+
+}
+
+SimPolicy::SimPolicy(PolicyKind kind, std::uint32_t seed, const Replay* script)
+: kind_(kind)
+, rng_(seed ^ 0x9e3779b9u)
+, script_(script)
+{
+    if (kind_ == PolicyKind::Script && (!script_ || script_->ticks() == 0)) kind_ = PolicyKind::Idle;
+}
+
+SimInput SimPolicy::next(const GameSim& sim) {
+    SimInput in;
+    switch (kind_) {
+    case PolicyKind::Random:
+        in.left = coin_(rng_);
+        in.right = !in.left && coin_(rng_);
+        in.fire = coin_(rng_);
+        break;
+    case PolicyKind::Bot:
+        in = botInput(sim);
+        break;
+    case PolicyKind::Script:
+        in = script_->input(cursor_);
+        if (++cursor_ == script_->ticks()) cursor_ = 0;
+        break;
+    case PolicyKind::Idle:
+        break;
+    }
+    return in;
+}
+
+std::optional<PolicyKind> SimPolicy::parse(std::string_view name) {
+    if (name == "idle") return PolicyKind::Idle;
+    if (name == "random") return PolicyKind::Random;
+    if (name == "bot") return PolicyKind::Bot;
+    if (name == "script") return PolicyKind::Script;
+    return std::nullopt;
+}
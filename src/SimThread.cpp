@@ -0,0 +1,247 @@
+#include "SimThread.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "Percentile.h"
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+float msBetween(std::uint64_t t0Ns, std::uint64_t t1Ns) {
+    return static_cast<float>(t1Ns - t0Ns) / 1e6f;
+}
+
+}
+
+SimThread::~SimThread() {
+    stop();
+}
+
+void SimThread::start(std::unique_ptr<GameSim> sim, float tickDt, int maxCatchUpTicks,
+                      std::unique_ptr<ReplayRecorder> recorder, std::unique_ptr<Replay> replay) {
+    stop();
+    sim_ = std::move(sim);
+    tickDt_ = tickDt;
+    tickNs_ = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(tickDt) * 1e9));
+    maxCatchUpTicks_ = std::max(1, maxCatchUpTicks);
+    recorder_ = std::move(recorder);
+    replay_ = std::move(replay);
+    if (replay_) replayPlayer_ = std::make_unique<ReplayPlayer>(*replay_);
+    // el primer Frame ya refleja la partida (aún sin hilo: nadie más escribe)
+    publish();
+    quit_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&SimThread::loop, this);
+}
+
+void SimThread::stop() {
+    if (!thread_.joinable()) return;
+    quit_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+std::uint32_t SimThread::send(const Command& c) {
+    if (!running()) return sent_;
+    // el hilo vacía la cola al menos una vez por tick: llena solo un instante
+    while (!commands_.push(c)) std::this_thread::yield();
+    return ++sent_;
+}
+
+std::uint32_t SimThread::pushAction(const ActionEvent& ev) {
+    Command c;
+    c.action = ev;
+    return send(c);
+}
+
+std::uint32_t SimThread::resume(std::uint32_t heldMask) {
+    Command c;
+    c.kind = Command::Kind::Resume;
+    c.heldMask = heldMask;
+    return send(c);
+}
+
+std::uint32_t SimThread::pause() {
+    Command c;
+    c.kind = Command::Kind::Pause;
+    return send(c);
+}
+
+std::uint32_t SimThread::reset() {
+    Command c;
+    c.kind = Command::Kind::Reset;
+    return send(c);
+}
+
+void SimThread::drainCommands() {
+    Command c;
+    while (commands_.pop(c)) {
+        ++processed_;
+        switch (c.kind) {
+        case Command::Kind::Action:
+            // parada o en replay, las acciones de juego no cuentan
+            if (advancing_ && !replayPlayer_) ring_.push(c.action);
+            break;
+        case Command::Kind::Resume:
+            advancing_ = true;
+            // lo que diga el teclado al volver entra como eventos ya vencidos (y así queda en la grabación)
+            for (std::size_t i = 0; i < GAMEPLAY_ACTION_COUNT; ++i) {
+                const auto a = static_cast<Action>(i);
+                const bool down = (c.heldMask >> i) & 1u;
+                if (down != actionState_.held(a)) ring_.push(ActionEvent{ 0, a, down });
+            }
+            break;
+        case Command::Kind::Pause:
+            advancing_ = false;
+            ring_.clear();
+            break;
+        case Command::Kind::Reset:
+            if (replayPlayer_) endReplay();
+            if (!simFresh_) {
+                sim_->reset();
+                simFresh_ = true;
+                resetBeforeStep_ = true;
+            }
+            halted_ = false;
+            break;
+        }
+    }
+}
+
+void SimThread::loop() {
+    std::uint64_t next = 0; // límite del próximo tick; 0 = recién reanudado
+    while (!quit_.load(std::memory_order_acquire)) {
+        const std::uint32_t before = processed_;
+        drainCommands();
+        if (!advancing_ || halted_) {
+            // parado: solo se publica para que el principal vea atendidas sus órdenes
+            next = 0;
+            if (processed_ != before) publish();
+            sf::sleep(sf::microseconds(static_cast<std::int64_t>(IDLE_SLEEP_US)));
+            continue;
+        }
+        const std::uint64_t now = actionClockNs();
+        if (next == 0) {
+            // como el acumulador a cero de antes: el primer tick llega un paso después de reanudar
+            next = now + tickNs_;
+            lastStartNs_ = 0;
+        }
+        if (now < next) {
+            sf::sleep(sf::microseconds(static_cast<std::int64_t>((next - now) / 1000)));
+            continue;
+        }
+        // más de maxCatchUpTicks por detrás: no se intenta recuperar, se descarta el tiempo sobrante
+        const std::uint64_t behind = (now - next) / tickNs_ + 1;
+        if (behind > static_cast<std::uint64_t>(maxCatchUpTicks_)) {
+            const std::uint64_t skip = behind - static_cast<std::uint64_t>(maxCatchUpTicks_);
+            stats_.dropped += skip;
+            next += skip * tickNs_;
+        }
+        measure(now, next);
+        runTick(next - tickNs_, next);
+        next += tickNs_;
+        publish();
+    }
+}
+
+void SimThread::runTick(std::uint64_t tickStartNs, std::uint64_t tickEndNs) {
+    PROFILE_ZONE("sim.tick");
+    if (replayPlayer_) {
+        // las grabaciones de las herramientas no traen acciones: van por los bits de cada tick
+        if (replay_->actions().empty()) replayPlayer_->step(*sim_);
+        else replayPlayer_->step(*sim_, replayActions());
+    } else {
+        const SimInput input = consumeActions(tickStartNs, tickEndNs);
+        sim_->step(input, tickDt_);
+        if (recorder_) recorder_->record(input, resetBeforeStep_, *sim_);
+        resetBeforeStep_ = false;
+    }
+    simFresh_ = false;
+    ++ticks_;
+    lastTickNs_ = tickEndNs;
+    for (const SimEvent& ev : sim_->events())
+        if (!events_.push(ev)) droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    if (replayPlayer_ && replayPlayer_->done()) endReplay();
+    // en la grabación el jugador reinició desde la pantalla de resultado: se sigue
+    halted_ = sim_->isOver() && !(replayPlayer_ && replayPlayer_->resetPending());
+}
+
+// aplica en orden los eventos que llegaron hasta el final de este tick
+SimInput SimThread::consumeActions(std::uint64_t tickStartNs, std::uint64_t tickEndNs) {
+    const std::uint64_t span = std::max<std::uint64_t>(1, tickEndNs - tickStartNs);
+    while (!ring_.empty() && ring_.front().timeNs <= tickEndNs) {
+        const ActionEvent& ev = ring_.front();
+        actionState_.apply(ev.action, ev.pressed);
+        // las resincronizadas (tiempo 0) no tienen una pulsación real detrás
+        if (ev.pressed && ev.timeNs != 0) presses_.push(Press{ ev.timeNs, actionClockNs(), ticks_ + 1 });
+        if (recorder_) {
+            const std::uint64_t into = ev.timeNs > tickStartNs ? ev.timeNs - tickStartNs : 0;
+            recorder_->recordAction(ev.action, ev.pressed, static_cast<std::uint8_t>(std::min<std::uint64_t>(255, into * 256 / span)));
+        }
+        ring_.pop();
+    }
+    return actionState_.takeTick();
+}
+
+// el mismo camino que en vivo, alimentado con las acciones grabadas del tick actual
+SimInput SimThread::replayActions() {
+    const std::vector<ReplayAction>& actions = replay_->actions();
+    while (replayActionCursor_ < actions.size() && actions[replayActionCursor_].tick <= replayPlayer_->tick()) {
+        const ReplayAction& a = actions[replayActionCursor_++];
+        actionState_.apply(static_cast<Action>(a.action), a.pressed != 0);
+    }
+    return actionState_.takeTick();
+}
+
+void SimThread::endReplay() {
+    if (!replayPlayer_) return;
+    if (replayPlayer_->firstDivergence())
+        std::cerr << "[WARN] replay diverged at tick " << *replayPlayer_->firstDivergence() << " (" << replayPlayer_->divergentTicks() << " ticks differ)\n";
+    else
+        std::cerr << "[INFO] replay finished: " << replayPlayer_->tick() << " ticks, checksums match\n";
+    replayPlayer_.reset();
+    replay_.reset();
+    // el jugador retoma el control desde el teclado real (Game manda un resume con lo pulsado)
+    actionState_ = ActionState{};
+    replayActionCursor_ = 0;
+}
+
+// startNs: cuándo empezó de verdad el tick con límite tickEndNs
+void SimThread::measure(std::uint64_t startNs, std::uint64_t tickEndNs) {
+    const std::uint64_t prev = lastStartNs_;
+    lastStartNs_ = startNs;
+    if (prev == 0) return; // primer tick tras reanudar: sin intervalo
+    const float interval = msBetween(prev, startNs);
+    const float late = msBetween(tickEndNs, startNs);
+    const std::size_t slot = static_cast<std::size_t>(samples_ % STATS_WINDOW);
+    intervalMs_[slot] = interval;
+    lateMs_[slot] = late;
+    ++samples_;
+    stats_.intervalMax = std::max(stats_.intervalMax, interval);
+    stats_.lateMax = std::max(stats_.lateMax, late);
+    if (samples_ % STATS_EVERY != 0) return;
+
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(samples_, STATS_WINDOW));
+    std::array<float, STATS_WINDOW> scratch = intervalMs_;
+    float sum = 0.f;
+    for (std::size_t i = 0; i < n; ++i) sum += scratch[i];
+    stats_.hz = sum > 0.f ? 1000.f * static_cast<float>(n) / sum : 0.f;
+    const auto end = scratch.begin() + static_cast<std::ptrdiff_t>(n);
+    stats_.intervalP50 = percentile(scratch.begin(), end, 0.50);
+    stats_.intervalP99 = percentile(scratch.begin(), end, 0.99);
+    scratch = lateMs_;
+    stats_.lateP50 = percentile(scratch.begin(), end, 0.50);
+    stats_.lateP99 = percentile(scratch.begin(), end, 0.99);
+}
+
+void SimThread::publish() {
+    PROFILE_ZONE("sim.publish");
+    Frame& f = frames_.back();
+    f.snapshot.capture(*sim_);
+    f.tickNs = lastTickNs_;
+    f.ticks = ticks_;
+    f.commandSerial = processed_;
+    f.halted = halted_;
+    f.replaying = replayPlayer_ != nullptr;
+    f.stats = stats_;
+    frames_.publish();
+}
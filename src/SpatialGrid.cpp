@@ -0,0 +1,57 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(const sf::Vector2f& origin, float cellSize, int cols, int rows)
+: origin_(origin)
+, invCell_(1.f / cellSize)
+, cols_(std::max(1, cols))
+, rows_(std::max(1, rows))
+{
+    cellStart_.assign(static_cast<std::size_t>(cols_ * rows_) + 1, 0);
+}
+
+void SpatialGrid::cellRange(const sf::FloatRect& box, int& c0, int& r0, int& c1, int& r1) const {
+    // lo que cae fuera de la rejilla se agrupa en las celdas del borde
+    auto cellOf = [](float v, int count) {
+        int c = static_cast<int>(std::floor(v));
+        return std::clamp(c, 0, count - 1);
+    };
+    c0 = cellOf((box.position.x - origin_.x) * invCell_, cols_);
+    c1 = cellOf((box.position.x + box.size.x - origin_.x) * invCell_, cols_);
+    r0 = cellOf((box.position.y - origin_.y) * invCell_, rows_);
+    r1 = cellOf((box.position.y + box.size.y - origin_.y) * invCell_, rows_);
+}
+
+void SpatialGrid::begin(std::size_t maxId) {
+    entries_.clear();
+    occMin_ = { 1.f, 1.f };
+    occMax_ = { -1.f, -1.f };
+    if (stamp_.size() < maxId) stamp_.resize(maxId, 0);
+}
+
+void SpatialGrid::insert(std::uint32_t id, const sf::FloatRect& box) {
+    const sf::Vector2f lo = box.position;
+    const sf::Vector2f hi = box.position + box.size;
+    if (occMin_.x > occMax_.x) { occMin_ = lo; occMax_ = hi; }
+    else {
+        occMin_ = { std::min(occMin_.x, lo.x), std::min(occMin_.y, lo.y) };
+        occMax_ = { std::max(occMax_.x, hi.x), std::max(occMax_.y, hi.y) };
+    }
+    int c0, r0, c1, r1;
+    cellRange(box, c0, r0, c1, r1);
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
+            entries_.push_back(Entry{ static_cast<std::uint32_t>(r * cols_ + c), id });
+}
+
+void SpatialGrid::finish() {
+    std::fill(cellStart_.begin(), cellStart_.end(), 0u);
+    for (const Entry& e : entries_) ++cellStart_[e.cell + 1];
+    for (std::size_t i = 1; i < cellStart_.size(); ++i) cellStart_[i] += cellStart_[i - 1];
+
+    items_.resize(entries_.size());
+    std::vector<std::uint32_t>& cursor = scratch_;
+    cursor.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (const Entry& e : entries_) items_[cursor[e.cell]++] = e.id;
+}
@@ -0,0 +1,43 @@
+#include "SpriteBatch.h"
+
+SpriteBatch::Bucket& SpriteBatch::bucketFor(const sf::Texture* texture) {
+    // pocas texturas por capa: una búsqueda lineal basta
+    for (std::size_t i = 0; i < used_; ++i) {
+        if (buckets_[i].texture == texture) return buckets_[i];
+    }
+    if (used_ == buckets_.size()) buckets_.emplace_back();
+    Bucket& b = buckets_[used_++];
+    b.texture = texture;
+    b.vertices.clear();
+    return b;
+}
+
+void SpriteBatch::add(const sf::Texture* texture, const sf::FloatRect& dest, const sf::FloatRect& texRect, const sf::Color& color) {
+    Bucket& b = bucketFor(texture);
+    const float l = dest.position.x, t = dest.position.y;
+    const float r = l + dest.size.x, btm = t + dest.size.y;
+    const float u0 = texRect.position.x, v0 = texRect.position.y;
+    const float u1 = u0 + texRect.size.x, v1 = v0 + texRect.size.y;
+
+    b.vertices.append(sf::Vertex{ { l, t }, color, { u0, v0 } });
+    b.vertices.append(sf::Vertex{ { r, t }, color, { u1, v0 } });
+    b.vertices.append(sf::Vertex{ { l, btm }, color, { u0, v1 } });
+    b.vertices.append(sf::Vertex{ { l, btm }, color, { u0, v1 } });
+    b.vertices.append(sf::Vertex{ { r, t }, color, { u1, v0 } });
+    b.vertices.append(sf::Vertex{ { r, btm }, color, { u1, v1 } });
+    ++stats_.quads;
+}
+
+void SpriteBatch::flush(sf::RenderTarget& target, const sf::RenderStates& states) {
+    for (std::size_t i = 0; i < used_; ++i) {
+        Bucket& b = buckets_[i];
+        if (b.vertices.getVertexCount() == 0) continue;
+        sf::RenderStates st = states;
+        st.texture = b.texture;
+        target.draw(b.vertices, st);
+        ++stats_.drawCalls;
+        stats_.vertices += b.vertices.getVertexCount();
+        b.vertices.clear();
+    }
+    used_ = 0;
+}
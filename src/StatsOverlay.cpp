@@ -0,0 +1,74 @@
+#include "StatsOverlay.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+StatsOverlay::StatsOverlay(const sf::Font* font) {
+    if (font) {
+        text_.emplace(*font, "", 14);
+        text_->setFillColor(sf::Color(220,220,220));
+    }
+    panel_.setFillColor(sf::Color(0,0,0,170));
+}
+
+void StatsOverlay::pushFrameTime(float seconds) {
+    frameMs_[frameHead_] = seconds * 1000.f;
+    frameHead_ = (frameHead_ + 1) % GRAPH_SAMPLES;
+}
+
+bool StatsOverlay::update(float dt) {
+    if (!visible_) return false;
+    refreshTimer_ -= dt;
+    if (refreshTimer_ > 0.f) return false;
+    refreshTimer_ = 0.25f;
+    return true;
+}
+
+void StatsOverlay::refresh(const std::string& counters) {
+    if (!text_) return;
+    std::string s;
+    char line[96];
+    // con GALAGA_ALLOC_TRACKING, también las reservas de cada zona desde el arranque
+    const bool allocs = AllocTracker::enabled();
+    if (allocs) std::snprintf(line, sizeof(line), "%-18s %8s %8s %8s\n", "zone", "p50 us", "p99 us", "allocs");
+    else std::snprintf(line, sizeof(line), "%-18s %8s %8s\n", "zone", "p50 us", "p99 us");
+    s += line;
+    for (const auto &z : Profiler::instance().summarize()) {
+        if (allocs) std::snprintf(line, sizeof(line), "%-18.18s %8.1f %8.1f %8llu\n", z.name, z.p50Us, z.p99Us, static_cast<unsigned long long>(z.allocs));
+        else std::snprintf(line, sizeof(line), "%-18.18s %8.1f %8.1f\n", z.name, z.p50Us, z.p99Us);
+        s += line;
+    }
+    s += counters;
+    text_->setString(s);
+}
+
+void StatsOverlay::draw(sf::RenderTarget& target) {
+    if (!visible_) return;
+    const sf::Vector2f origin{ 8.f, 72.f };
+    const float width = static_cast<float>(GRAPH_SAMPLES) * 2.f;
+
+    sf::FloatRect tb = text_ ? text_->getLocalBounds() : sf::FloatRect{};
+    panel_.setPosition(origin);
+    panel_.setSize({ std::max(width, tb.size.x) + 16.f, tb.position.y + tb.size.y + GRAPH_HEIGHT + 32.f });
+    target.draw(panel_);
+
+    if (text_) {
+        text_->setPosition(origin + sf::Vector2f{ 8.f, 4.f });
+        target.draw(*text_);
+    }
+
+    // gráfica: la muestra más antigua a la izquierda; la línea marca 16.7 ms
+    const float baseY = origin.y + tb.position.y + tb.size.y + 16.f + GRAPH_HEIGHT;
+    for (std::size_t i = 0; i < GRAPH_SAMPLES; ++i) {
+        float ms = frameMs_[(frameHead_ + i) % GRAPH_SAMPLES];
+        float h = std::min(ms / GRAPH_MAX_MS, 1.f) * GRAPH_HEIGHT;
+        graph_[i].position = { origin.x + 8.f + static_cast<float>(i) * 2.f, baseY - h };
+        graph_[i].color = ms > 17.f ? sf::Color(255,90,90) : sf::Color(120,230,120);
+    }
+    const float budgetY = baseY - (1000.f / 60.f) / GRAPH_MAX_MS * GRAPH_HEIGHT;
+    budgetLine_[0].position = { origin.x + 8.f, budgetY };
+    budgetLine_[1].position = { origin.x + 8.f + width, budgetY };
+    budgetLine_[0].color = budgetLine_[1].color = sf::Color(200,200,80);
+    target.draw(budgetLine_);
+    target.draw(graph_);
+}
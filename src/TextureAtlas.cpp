@@ -0,0 +1,147 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+TextureAtlas::TextureAtlas(unsigned int pageSize, unsigned int padding)
+: pageSize_(pageSize), padding_(padding) {
+}
+
+std::vector<std::uint8_t> TextureAtlas::downscale(const sf::Image& image, sf::Vector2u dst) {
+    const sf::Vector2u src = image.getSize();
+    const std::uint8_t* in = image.getPixelsPtr();
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(dst.x) * dst.y * 4);
+    const float sx = static_cast<float>(src.x) / static_cast<float>(dst.x);
+    const float sy = static_cast<float>(src.y) / static_cast<float>(dst.y);
+
+    // promedio por área con alfa premultiplicado para no oscurecer los bordes
+    for (unsigned int y = 0; y < dst.y; ++y) {
+        unsigned int y0 = static_cast<unsigned int>(y * sy);
+        unsigned int y1 = std::max(y0 + 1, std::min(src.y, static_cast<unsigned int>(std::ceil((y + 1) * sy))));
+        for (unsigned int x = 0; x < dst.x; ++x) {
+            unsigned int x0 = static_cast<unsigned int>(x * sx);
+            unsigned int x1 = std::max(x0 + 1, std::min(src.x, static_cast<unsigned int>(std::ceil((x + 1) * sx))));
+            float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+            for (unsigned int yy = y0; yy < y1; ++yy) {
+                const std::uint8_t* p = in + (static_cast<std::size_t>(yy) * src.x + x0) * 4;
+                for (unsigned int xx = x0; xx < x1; ++xx, p += 4) {
+                    float pa = p[3] / 255.f;
+                    r += p[0] * pa; g += p[1] * pa; b += p[2] * pa; a += pa;
+                }
+            }
+            std::uint8_t* o = &out[(static_cast<std::size_t>(y) * dst.x + x) * 4];
+            const float n = static_cast<float>((x1 - x0) * (y1 - y0));
+            if (a > 0.f) {
+                o[0] = static_cast<std::uint8_t>(std::min(255.f, r / a + 0.5f));
+                o[1] = static_cast<std::uint8_t>(std::min(255.f, g / a + 0.5f));
+                o[2] = static_cast<std::uint8_t>(std::min(255.f, b / a + 0.5f));
+            }
+            o[3] = static_cast<std::uint8_t>(std::min(255.f, a / n * 255.f + 0.5f));
+        }
+    }
+    return out;
+}
+
+sf::Vector2u TextureAtlas::fitSize(sf::Vector2u src, unsigned int maxSize) {
+    const unsigned int longest = std::max(src.x, src.y);
+    if (maxSize == 0 || longest <= maxSize) return src;
+    float scale = static_cast<float>(maxSize) / static_cast<float>(longest);
+    return { std::max(1u, static_cast<unsigned int>(std::lround(src.x * scale))),
+             std::max(1u, static_cast<unsigned int>(std::lround(src.y * scale))) };
+}
+
+sf::Image TextureAtlas::shrinkToFit(const sf::Image& image, unsigned int maxSize) {
+    const sf::Vector2u src = image.getSize();
+    const sf::Vector2u dst = fitSize(src, maxSize);
+    if (src.x == 0 || src.y == 0 || dst == src) return image;
+    return sf::Image(dst, downscale(image, dst).data());
+}
+
+void TextureAtlas::add(const std::string& name, const sf::Image& image, unsigned int maxSize) {
+    const sf::Vector2u src = image.getSize();
+    if (src.x == 0 || src.y == 0) return;
+
+    Entry e;
+    e.name = name;
+    const sf::Vector2u dst = fitSize(src, maxSize);
+    if (dst != src) {
+        e.size = dst;
+        e.pixels = downscale(image, e.size);
+    } else {
+        e.size = src;
+        const std::uint8_t* p = image.getPixelsPtr();
+        e.pixels.assign(p, p + static_cast<std::size_t>(src.x) * src.y * 4);
+    }
+    entries_.push_back(std::move(e));
+}
+
+bool TextureAtlas::build() {
+    pages_.clear();
+    for (Entry& e : entries_) e.placed = false;
+    if (entries_.empty()) return true;
+
+    std::vector<std::size_t> order(entries_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return entries_[a].size.y > entries_[b].size.y;
+    });
+
+    // estantes: se llena de izquierda a derecha, la altura del estante la marca el primero
+    unsigned int page = 0, x = padding_, y = padding_, shelfH = 0;
+    std::vector<sf::Vector2u> pageExtent(1, { 0u, 0u });
+    bool ok = true;
+    for (std::size_t idx : order) {
+        Entry& e = entries_[idx];
+        if (e.size.x + 2 * padding_ > pageSize_ || e.size.y + 2 * padding_ > pageSize_) {
+            std::cerr << "[WARN] atlas: " << e.name << " does not fit in a " << pageSize_ << " page\n";
+            e.pixels.clear();
+            ok = false;
+            continue;
+        }
+        if (x + e.size.x + padding_ > pageSize_) { x = padding_; y += shelfH + padding_; shelfH = 0; }
+        if (y + e.size.y + padding_ > pageSize_) {
+            ++page; x = padding_; y = padding_; shelfH = 0;
+            pageExtent.push_back({ 0u, 0u });
+        }
+        e.page = page;
+        e.pos = { x, y };
+        e.placed = true;
+        x += e.size.x + padding_;
+        shelfH = std::max(shelfH, e.size.y);
+        pageExtent[page].x = std::max(pageExtent[page].x, x);
+        pageExtent[page].y = std::max(pageExtent[page].y, y + e.size.y + padding_);
+    }
+
+    // cada página se recorta a lo que realmente usa
+    for (std::size_t p = 0; p < pageExtent.size(); ++p) {
+        const sf::Vector2u extent = pageExtent[p];
+        if (extent.x == 0 || extent.y == 0) { pages_.push_back(std::make_unique<sf::Texture>()); continue; }
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(extent.x) * extent.y * 4, 0);
+        for (Entry& e : entries_) {
+            if (e.page != p || e.pixels.empty()) continue;
+            for (unsigned int row = 0; row < e.size.y; ++row) {
+                std::copy_n(&e.pixels[static_cast<std::size_t>(row) * e.size.x * 4],
+                            static_cast<std::size_t>(e.size.x) * 4,
+                            &pixels[(static_cast<std::size_t>(e.pos.y + row) * extent.x + e.pos.x) * 4]);
+            }
+        }
+        auto tex = std::make_unique<sf::Texture>();
+        if (!tex->resize(extent)) { std::cerr << "[WARN] atlas: could not create page " << p << "\n"; ok = false; }
+        else tex->update(pixels.data());
+        pages_.push_back(std::move(tex));
+    }
+    for (Entry& e : entries_) { e.pixels.clear(); e.pixels.shrink_to_fit(); }
+    return ok;
+}
+
+TextureAtlas::Region TextureAtlas::region(const std::string& name) const {
+    for (const Entry& e : entries_) {
+        if (e.name != name || !e.placed || e.page >= pages_.size()) continue;
+        Region r;
+        r.texture = pages_[e.page].get();
+        r.rect = sf::FloatRect(sf::Vector2f(e.pos), sf::Vector2f(e.size));
+        return r;
+    }
+    return Region{};
+}
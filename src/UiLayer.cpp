@@ -0,0 +1,169 @@
+#include "UiLayer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+
+// se rasteriza con alfa premultiplicado para que la composición posterior no aplique el alfa dos veces
+const sf::BlendMode RASTER_BLEND(sf::BlendMode::Factor::SrcAlpha, sf::BlendMode::Factor::OneMinusSrcAlpha, sf::BlendMode::Equation::Add,
+                                 sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha, sf::BlendMode::Equation::Add);
+const sf::BlendMode COMPOSITE_BLEND(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+
+}
+
+UiLayer::Id UiLayer::push(Widget w) {
+    widgets_.push_back(std::move(w));
+    dirty_ = true;
+    return widgets_.size() - 1;
+}
+
+UiLayer::Id UiLayer::addText(const sf::Font& font, const sf::String& str, unsigned int charSize, sf::Color color) {
+    sf::Text text(font, str, charSize);
+    text.setFillColor(color);
+    return push(Widget{ std::move(text), {}, Fit::None, color });
+}
+
+UiLayer::Id UiLayer::addRect(const sf::Vector2f& size, sf::Color fill, sf::Color outline, float outlineThickness) {
+    sf::RectangleShape rect(size);
+    rect.setFillColor(fill);
+    rect.setOutlineColor(outline);
+    rect.setOutlineThickness(outlineThickness);
+    return push(Widget{ std::move(rect), {}, Fit::None, fill });
+}
+
+UiLayer::Id UiLayer::addShape(const sf::ConvexShape& shape) {
+    return push(Widget{ shape, {}, Fit::None, shape.getFillColor() });
+}
+
+UiLayer::Id UiLayer::addBackdrop(sf::Color fill) {
+    sf::RectangleShape rect;
+    rect.setFillColor(fill);
+    return push(Widget{ std::move(rect), {}, Fit::Stretch, fill });
+}
+
+UiLayer::Id UiLayer::addCover(const sf::Texture& texture) {
+    return push(Widget{ sf::Sprite(texture), {}, Fit::Cover, sf::Color::White });
+}
+
+void UiLayer::setString(Id id, const sf::String& str) {
+    if (auto* text = std::get_if<sf::Text>(&widgets_[id].item)) {
+        if (text->getString() == str) return;
+        text->setString(str);
+        dirty_ = true;
+    }
+}
+
+void UiLayer::setAscii(Id id, std::string_view str) {
+    scratch_.clear();
+    // de uno en uno: un carácter suelto cabe en el búfer interno del sf::String temporal
+    for (char c : str) scratch_ += sf::String(static_cast<char32_t>(static_cast<unsigned char>(c)));
+    setString(id, scratch_);
+}
+
+void UiLayer::setFillColor(Id id, sf::Color color) {
+    Widget& w = widgets_[id];
+    if (w.fill == color) return;
+    w.fill = color;
+    std::visit([&](auto& d) {
+        using T = std::decay_t<decltype(d)>;
+        if constexpr (std::is_same_v<T, sf::Sprite>) d.setColor(color);
+        else d.setFillColor(color);
+    }, w.item);
+    dirty_ = true;
+}
+
+void UiLayer::setSize(Id id, const sf::Vector2f& size) {
+    if (auto* rect = std::get_if<sf::RectangleShape>(&widgets_[id].item)) {
+        if (rect->getSize() == size) return;
+        rect->setSize(size);
+        dirty_ = true;
+    }
+}
+
+void UiLayer::setVisible(Id id, bool visible) {
+    if (widgets_[id].visible == visible) return;
+    widgets_[id].visible = visible;
+    dirty_ = true;
+}
+
+void UiLayer::place(Id id, const UiPlacement& placement) {
+    widgets_[id].placement = placement;
+    dirty_ = true;
+}
+
+void UiLayer::layout(Widget& w) {
+    const sf::Vector2f win(size_);
+    const UiPlacement& p = w.placement;
+    std::visit([&](auto& d) {
+        using T = std::decay_t<decltype(d)>;
+        if constexpr (std::is_same_v<T, sf::RectangleShape>) {
+            if (w.fit == Fit::Stretch) {
+                d.setSize(win);
+                d.setPosition({ 0.f, 0.f });
+                return;
+            }
+        }
+        if constexpr (std::is_same_v<T, sf::Sprite>) {
+            if (w.fit == Fit::Cover) {
+                const sf::Vector2f ts(d.getTexture().getSize());
+                if (ts.x <= 0.f || ts.y <= 0.f) return;
+                const float scale = std::max(win.x / ts.x, win.y / ts.y);
+                d.setScale({ scale, scale });
+                d.setPosition({ (win.x - ts.x * scale) / 2.f, (win.y - ts.y * scale) / 2.f });
+                return;
+            }
+        }
+        // floor/round para que el texto caiga en píxeles enteros
+        const sf::FloatRect lb = d.getLocalBounds();
+        d.setOrigin({ std::floor(lb.position.x + lb.size.x * p.align.x), std::floor(lb.position.y + lb.size.y * p.align.y) });
+        d.setPosition({ std::round(win.x * p.anchor.x + p.offset.x), std::round(win.y * p.anchor.y + p.offset.y) });
+    }, w.item);
+}
+
+sf::FloatRect UiLayer::bounds(Id id) {
+    Widget& w = widgets_[id];
+    layout(w);
+    return std::visit([](const auto& d) { return d.getGlobalBounds(); }, w.item);
+}
+
+bool UiLayer::resize(sf::Vector2u size) {
+    size_ = size;
+    dirty_ = true;
+    canvasSprite_.reset();
+    if (size.x == 0 || size.y == 0) return false;
+    if (!canvas_.resize(size)) {
+        std::cerr << "[WARN] UiLayer: could not create render texture, drawing widgets directly\n";
+        return false;
+    }
+    canvasSprite_.emplace(canvas_.getTexture());
+    return true;
+}
+
+void UiLayer::draw(sf::RenderTarget& target) {
+    const sf::Vector2u size = target.getSize();
+    if (size != size_) resize(size);
+
+    if (!canvasSprite_) {
+        // sin caché: se dibuja todo cada frame
+        for (Widget& w : widgets_) {
+            if (dirty_) layout(w);
+            if (w.visible) std::visit([&](const auto& d) { target.draw(d); }, w.item);
+        }
+        dirty_ = false;
+        return;
+    }
+
+    if (dirty_) {
+        canvas_.clear(sf::Color::Transparent);
+        for (Widget& w : widgets_) {
+            layout(w);
+            if (w.visible) std::visit([&](const auto& d) { canvas_.draw(d, sf::RenderStates(RASTER_BLEND)); }, w.item);
+        }
+        canvas_.display();
+        dirty_ = false;
+        ++rasterCount_;
+    }
+    target.draw(*canvasSprite_, sf::RenderStates(COMPOSITE_BLEND));
+}
@@ -0,0 +1,336 @@
+#include "GameSim.h"
+#include "Profiler.h"
+#include "Percentile.h"
+#include "Replay.h"
+#include "SimPolicy.h"
+#include "ShieldMask.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Barrido de parámetros de dificultad: miles de partidas sin ventana repartidas en todos los núcleos.
+// uso: galaga_batch [--speed-step a,b,...] [--descend-step ...] [--bounce ...] [--fire-step ...]
+//                   [--seeds N] [--seed-base S] [--policy idle|random|bot|script] [--script in.grp]
+//                   [--hz H] [--max-seconds T] [--threads N] [--csv out.csv] [--json out.json] [--shield shield.png]
+//                   [--cols N] [--rows N] [--player-bullets N] [--enemy-bullets N] [--fire-rate X] [--shoot-cooldown S] [--shields N]
+// Cada punto de la rejilla juega --seeds partidas (semillas seed-base..seed-base+N-1) hasta perder o agotar el tiempo.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Colas por hilo: el dueño saca por detrás y, cuando se le acaba, roba por delante a los demás.
+// Las tareas (partidas enteras) duran milisegundos, así que un mutex por cola no se nota.
+class WorkStealingScheduler {
+public:
+    explicit WorkStealingScheduler(std::size_t workers) : queues_(workers) {}
+
+    // reparte [0, count) en bloques contiguos, uno por hilo
+    void seed(std::size_t count) {
+        const std::size_t n = queues_.size();
+        for (std::size_t w = 0; w < n; ++w) {
+            const std::size_t begin = count * w / n;
+            const std::size_t end = count * (w + 1) / n;
+            for (std::size_t t = begin; t < end; ++t) queues_[w].tasks.push_back(t);
+        }
+    }
+
+    std::optional<std::size_t> next(std::size_t w) {
+        {
+            Queue& own = queues_[w];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                const std::size_t t = own.tasks.back();
+                own.tasks.pop_back();
+                return t;
+            }
+        }
+        for (std::size_t k = 1; k < queues_.size(); ++k) {
+            Queue& victim = queues_[(w + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            const std::size_t t = victim.tasks.front();
+            victim.tasks.pop_front();
+            ++queues_[w].steals; // solo lo escribe su dueño
+            return t;
+        }
+        return std::nullopt;
+    }
+
+    std::uint64_t steals() const {
+        std::uint64_t total = 0;
+        for (const Queue& q : queues_) total += q.steals;
+        return total;
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+        std::uint64_t steals = 0;
+    };
+    std::vector<Queue> queues_;
+};
+
+struct GridPoint {
+    float speedStep;
+    float descendStep;
+    float bounce;
+    float fireStep;
+};
+
+struct GameResult {
+    int wave = 1;
+    int score = 0;
+    std::uint64_t ticks = 0;
+    bool capped = false; // se agotó --max-seconds sin perder
+};
+
+struct Distribution {
+    double mean = 0.0, p10 = 0.0, p50 = 0.0, p90 = 0.0, max = 0.0;
+};
+
+Distribution distribution(std::vector<double> v) {
+    Distribution d;
+    if (v.empty()) return d;
+    for (double x : v) d.mean += x;
+    d.mean /= static_cast<double>(v.size());
+    d.p10 = percentile(v.begin(), v.end(), 0.10);
+    d.p50 = percentile(v.begin(), v.end(), 0.50);
+    d.p90 = percentile(v.begin(), v.end(), 0.90);
+    d.max = *std::max_element(v.begin(), v.end());
+    return d;
+}
+
+struct PointSummary {
+    GridPoint point;
+    std::size_t games = 0;
+    std::size_t capped = 0;
+    Distribution wave, seconds, score;
+};
+
+bool parseList(const char* text, std::vector<float>& out) {
+    out.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        const float v = std::strtof(item.c_str(), &end);
+        if (end == item.c_str()) return false;
+        out.push_back(v);
+    }
+    return !out.empty();
+}
+
+GameResult runGame(SimConfig cfg, const GridPoint& p, std::uint32_t seed, PolicyKind policy, const Replay* script,
+                   const ShieldMask* shield, float dt, std::uint64_t maxTicks) {
+    cfg.waveSpeedStep = p.speedStep;
+    cfg.waveDescendStep = p.descendStep;
+    cfg.bounceSpeedup = p.bounce;
+    cfg.waveFireRateStep = p.fireStep;
+    GameSim sim(cfg, seed);
+    if (shield) sim.setShieldShape(*shield);
+    SimPolicy inputs(policy, seed, script);
+    GameResult r;
+    while (!sim.isOver() && r.ticks < maxTicks) {
+        sim.step(inputs.next(sim), dt);
+        ++r.ticks;
+    }
+    r.wave = sim.wave();
+    r.score = sim.score();
+    r.capped = !sim.isOver();
+    return r;
+}
+
+void writeDistributionCsv(std::ostream& out, const Distribution& d) {
+    out << ',' << d.mean << ',' << d.p10 << ',' << d.p50 << ',' << d.p90 << ',' << d.max;
+}
+
+void writeDistributionJson(std::ostream& out, const char* name, const Distribution& d) {
+    out << "\"" << name << "\": {\"mean\": " << d.mean << ", \"p10\": " << d.p10 << ", \"p50\": " << d.p50
+        << ", \"p90\": " << d.p90 << ", \"max\": " << d.max << "}";
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<float> speedSteps{ SimConfig{}.waveSpeedStep };
+    std::vector<float> descendSteps{ SimConfig{}.waveDescendStep };
+    std::vector<float> bounces{ SimConfig{}.bounceSpeedup };
+    std::vector<float> fireSteps{ SimConfig{}.waveFireRateStep };
+    std::size_t seeds = 100;
+    std::uint32_t seedBase = 1;
+    PolicyKind policy = PolicyKind::Bot;
+    std::string scriptPath;
+    float hz = 120.f;
+    float maxSeconds = 600.f;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string csvPath;
+    std::string jsonPath;
+    std::string shieldPath;
+    SimConfig base;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (arg == "--speed-step" && hasValue) ok = parseList(argv[++i], speedSteps);
+        else if (arg == "--descend-step" && hasValue) ok = parseList(argv[++i], descendSteps);
+        else if (arg == "--bounce" && hasValue) ok = parseList(argv[++i], bounces);
+        else if (arg == "--fire-step" && hasValue) ok = parseList(argv[++i], fireSteps);
+        else if (arg == "--seeds" && hasValue) seeds = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed-base" && hasValue) seedBase = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--script" && hasValue) scriptPath = argv[++i];
+        else if (arg == "--hz" && hasValue) hz = std::strtof(argv[++i], nullptr);
+        else if (arg == "--max-seconds" && hasValue) maxSeconds = std::strtof(argv[++i], nullptr);
+        else if (arg == "--threads" && hasValue) threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--shield" && hasValue) shieldPath = argv[++i];
+        else if (arg == "--policy" && hasValue) {
+            std::optional<PolicyKind> p = SimPolicy::parse(argv[++i]);
+            ok = p.has_value();
+            if (p) policy = *p;
+        } else if (hasValue && applySimFlag(base, arg, argv[i + 1])) ++i;
+        else ok = false;
+        if (!ok) {
+            std::cerr << "usage: galaga_batch [--speed-step a,b,...] [--descend-step ...] [--bounce ...] [--fire-step ...]\n"
+                         "                    [--seeds N] [--seed-base S] [--policy idle|random|bot|script] [--script in.grp]\n"
+                         "                    [--hz H] [--max-seconds T] [--threads N] [--csv out.csv] [--json out.json]\n"
+                         "                    [--shield shield.png] " << SIM_FLAGS_USAGE << "\n";
+            return 1;
+        }
+    }
+    if (hz <= 0.f) hz = 120.f;
+    const float dt = 1.f / hz;
+    const auto maxTicks = static_cast<std::uint64_t>(std::max(0.f, maxSeconds) * hz);
+    threads = std::max(1u, threads);
+
+    Replay script;
+    if (policy == PolicyKind::Script && (scriptPath.empty() || !script.load(scriptPath))) {
+        std::cerr << "--policy script needs a valid --script replay\n";
+        return 1;
+    }
+
+    // sin --shield, la forma por defecto de GameSim
+    std::optional<ShieldMask> shield;
+    if (!shieldPath.empty()) {
+        const sf::Vector2f size = base.shieldSize;
+        shield = ShieldMask::fromImageFile(shieldPath, { static_cast<int>(std::lround(size.x)), static_cast<int>(std::lround(size.y)) });
+        if (!shield) { std::cerr << "could not load shield image " << shieldPath << "\n"; return 1; }
+    }
+
+    std::vector<GridPoint> grid;
+    for (float s : speedSteps)
+        for (float d : descendSteps)
+            for (float b : bounces)
+                for (float f : fireSteps) grid.push_back(GridPoint{ s, d, b, f });
+
+    // nadie lee las zonas en el barrido: apagadas ni siquiera leen el reloj
+    Profiler::instance().setEnabled(false);
+
+    const std::size_t total = grid.size() * seeds;
+    std::vector<GameResult> results(total); // cada hueco lo escribe un único hilo
+    WorkStealingScheduler scheduler(threads);
+    scheduler.seed(total);
+
+    auto t0 = Clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned int w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w] {
+            while (std::optional<std::size_t> task = scheduler.next(w)) {
+                const GridPoint& p = grid[*task / seeds];
+                const auto seed = static_cast<std::uint32_t>(seedBase + *task % seeds);
+                results[*task] = runGame(base, p, seed, policy, policy == PolicyKind::Script ? &script : nullptr,
+                                        shield ? &*shield : nullptr, dt, maxTicks);
+            }
+        });
+    }
+    for (std::thread& t : workers) t.join();
+    auto t1 = Clock::now();
+
+    std::uint64_t ticks = 0;
+    std::vector<PointSummary> summaries;
+    summaries.reserve(grid.size());
+    for (std::size_t g = 0; g < grid.size(); ++g) {
+        PointSummary s;
+        s.point = grid[g];
+        std::vector<double> waves, secs, scores;
+        for (std::size_t k = 0; k < seeds; ++k) {
+            const GameResult& r = results[g * seeds + k];
+            ticks += r.ticks;
+            if (r.capped) ++s.capped;
+            waves.push_back(r.wave);
+            secs.push_back(static_cast<double>(r.ticks) * dt);
+            scores.push_back(r.score);
+        }
+        s.games = seeds;
+        s.wave = distribution(std::move(waves));
+        s.seconds = distribution(std::move(secs));
+        s.score = distribution(std::move(scores));
+        summaries.push_back(s);
+    }
+
+    const double wall = std::chrono::duration<double>(t1 - t0).count();
+    const double gamesPerSec = wall > 0.0 ? static_cast<double>(total) / wall : 0.0;
+    const double ticksPerSec = wall > 0.0 ? static_cast<double>(ticks) / wall : 0.0;
+    std::cout << "grid points: " << grid.size() << ", games: " << total << ", threads: " << threads << "\n"
+              << "wall: " << wall << " s, " << gamesPerSec << " games/s, " << ticksPerSec << " ticks/s ("
+              << ticksPerSec / threads << " per thread), steals: " << scheduler.steals() << "\n";
+    for (const PointSummary& s : summaries) {
+        std::cout << "  speed " << s.point.speedStep << " descend " << s.point.descendStep << " bounce " << s.point.bounce
+                  << " fire " << s.point.fireStep << ": wave p50 " << s.wave.p50 << " (max " << s.wave.max << "), survival p50 "
+                  << s.seconds.p50 << " s, score p50 " << s.score.p50 << ", capped " << s.capped << "/" << s.games << "\n";
+    }
+
+    if (!csvPath.empty()) {
+        std::ofstream out(csvPath);
+        if (!out) { std::cerr << "could not write " << csvPath << "\n"; return 1; }
+        out << "speed_step,descend_step,bounce,fire_step,games,capped"
+               ",wave_mean,wave_p10,wave_p50,wave_p90,wave_max"
+               ",seconds_mean,seconds_p10,seconds_p50,seconds_p90,seconds_max"
+               ",score_mean,score_p10,score_p50,score_p90,score_max\n";
+        for (const PointSummary& s : summaries) {
+            out << s.point.speedStep << ',' << s.point.descendStep << ',' << s.point.bounce << ',' << s.point.fireStep
+                << ',' << s.games << ',' << s.capped;
+            writeDistributionCsv(out, s.wave);
+            writeDistributionCsv(out, s.seconds);
+            writeDistributionCsv(out, s.score);
+            out << "\n";
+        }
+    }
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out) { std::cerr << "could not write " << jsonPath << "\n"; return 1; }
+        out << "{\n  \"threads\": " << threads << ",\n  \"games\": " << total << ",\n  \"seeds_per_point\": " << seeds
+            << ",\n  \"hz\": " << hz << ",\n  \"max_seconds\": " << maxSeconds << ",\n  \"wall_s\": " << wall
+            << ",\n  \"games_per_s\": " << gamesPerSec << ",\n  \"ticks_per_s\": " << ticksPerSec
+            << ",\n  \"steals\": " << scheduler.steals() << ",\n  \"points\": [\n";
+        for (std::size_t g = 0; g < summaries.size(); ++g) {
+            const PointSummary& s = summaries[g];
+            out << "    {\"speed_step\": " << s.point.speedStep << ", \"descend_step\": " << s.point.descendStep
+                << ", \"bounce\": " << s.point.bounce << ", \"fire_step\": " << s.point.fireStep
+                << ", \"games\": " << s.games << ", \"capped\": " << s.capped << ", ";
+            writeDistributionJson(out, "wave", s.wave);
+            out << ", ";
+            writeDistributionJson(out, "seconds", s.seconds);
+            out << ", ";
+            writeDistributionJson(out, "score", s.score);
+            out << "}" << (g + 1 < summaries.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+    return 0;
+}
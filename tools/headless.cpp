@@ -0,0 +1,423 @@
+#include "GameSim.h"
+#include "AllocTracker.h"
+#include "BulletPool.h"
+#include "Formation.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "SimPolicy.h"
+#include "ShieldMask.h"
+#include "Shield.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Ejecuta las reglas del juego sin ventana ni audio.
+// uso: galaga_headless [--ticks N] [--seed S] [--hz H] [--policy idle|random|bot] [--trace out.json]
+//                       [--record out.grp] [--replay in.grp] [--checksums out.txt] [--shield shield.png] [--alloc-check]
+//                       [--equivalence HZ [--hz REF] [--games N]]
+//                       [--cols N] [--rows N] [--player-bullets N] [--enemy-bullets N] [--fire-rate X] [--shoot-cooldown S] [--shields N]
+// Con --replay se re-simula la grabación a toda velocidad (semilla, paso y entradas salen del fichero).
+// Con --alloc-check (build con GALAGA_ALLOC_TRACKING) termina con código 3 si algún tick tras el
+// calentamiento reserva memoria: step, oleadas nuevas y reinicios de partida incluidos. Un pool de
+// balas que pasa de su capacidad también cuenta: con ritmos de disparo altos, subir --enemy-bullets.
+// Con --equivalence HZ se juegan --games partidas (una por semilla desde --seed) de cada escenario
+// (quieto, moviéndose, escudos finos; siempre disparando) a --hz, la referencia (240 por defecto
+// en este modo), y otra vez a HZ; --ticks, --policy, --trace, --record, --checksums y --alloc-check
+// no valen aquí. Los eventos de cada tipo tienen que salir iguales, en el mismo momento de la partida
+// (con un tick grueso de margen) y en el mismo sitio (a quién le dio); si no, termina con código 4.
+// Solo prueba el barrido si a HZ las balas llegan a cruzar lo que tienen delante en un tick (a 5 Hz
+// una bala del jugador avanza 96 px, más que un enemigo de 45 px más la propia bala): ejemplo,
+// --hz 240 --equivalence 5. Lo que no garantiza: dos impactos a menos de ~1 µs uno de otro se
+// resuelven según el redondeo, que depende del paso (la semilla 597 de 10 Hz para abajo: en el
+// EnemyKilled #31, a los 56.4 s, cae el enemigo de (394, 486) en vez del de (446, 523)); y a 2 Hz
+// la mordida de la formación en un escudo puede redondear a otro píxel en un trozo de medio
+// segundo, y una bala que llega en ese trozo da una fila más abajo (la semilla 704, ShieldHit #41)
+
+namespace {
+
+constexpr std::uint64_t ALLOC_WARMUP_TICKS = 600; // los pools y la rejilla llegan a su tamaño
+constexpr std::uint64_t ALLOC_REPORT_LIMIT = 10;
+constexpr float EQUIVALENCE_MAX_SECONDS = 600.f; // partidas que no acaban solas (formación sin bajar)
+constexpr float EQUIVALENCE_MAX_DRIFT = 0.5f;     // px entre las posiciones de un mismo evento (redondeo)
+constexpr float EQUIVALENCE_REFERENCE_HZ = 240.f; // --hz por defecto con --equivalence
+constexpr int EVENT_TYPES = static_cast<int>(SimEventType::WaveStarted) + 1;
+
+// zonas del Profiler cuyas reservas cambiaron entre before y after
+void printAllocZones(const std::vector<std::uint64_t>& before, const std::vector<std::uint64_t>& after) {
+    for (std::size_t i = 0; i < after.size(); ++i) {
+        const std::uint64_t was = i < before.size() ? before[i] : 0;
+        if (after[i] != was) std::cout << " " << Profiler::instance().zoneName(static_cast<std::uint32_t>(i)) << " " << after[i] - was;
+    }
+}
+
+// un checksum por línea: "tick hex", para comparar con diff entre builds
+void writeChecksum(std::ofstream& out, std::uint64_t tick, std::uint32_t sum) {
+    char line[32];
+    std::snprintf(line, sizeof(line), "%llu %08x\n", static_cast<unsigned long long>(tick), sum);
+    out << line;
+}
+
+// misma forma de escudo que el juego con ventana (sin --shield: ShieldMask::bunker)
+bool applyShield(GameSim& sim, const std::string& path) {
+    if (path.empty()) return true;
+    const sf::Vector2f size = sim.config().shieldSize;
+    std::optional<ShieldMask> shape = ShieldMask::fromImageFile(path, { static_cast<int>(std::lround(size.x)), static_cast<int>(std::lround(size.y)) });
+    if (!shape) { std::cerr << "could not load shield image " << path << "\n"; return false; }
+    sim.setShieldShape(*shape);
+    return true;
+}
+
+const char* eventName(int type) {
+    static constexpr const char* NAMES[EVENT_TYPES] = { "PlayerShot", "EnemyKilled", "ShieldHit", "PlayerHit", "GameOver", "WaveStarted" };
+    return NAMES[type];
+}
+
+struct EventRecord {
+    float time;  // segundos desde el principio de la partida (final del tick)
+    int value;
+    sf::Vector2f position; // la del SimEvent: en el instante del impacto, no depende del paso
+};
+
+struct GameLog {
+    std::array<std::vector<EventRecord>, EVENT_TYPES> events;
+    // desde que un enemigo llega a los escudos también salen ShieldHit por comérselos, uno por trozo
+    // de tick y enemigo: cuántos depende del paso, así que a partir de ahí esos no se comparan
+    float erosionFrom = EQUIVALENCE_MAX_SECONDS;
+    float endTime = 0.f; // final del último tick
+    std::uint64_t ticks = 0;
+    std::uint64_t sweptHits = 0;
+    double wallSeconds = 0.0;
+};
+
+// borde inferior del enemigo vivo más bajo
+float lowestEnemy(const GameSim& sim) {
+    const Formation* f = sim.formation();
+    if (!f) return 0.f;
+    float bottom = 0.f;
+    for (std::size_t i = 0; i < f->size(); ++i)
+        if (f->isAlive(i)) bottom = std::max(bottom, f->bounds(i).position.y + f->bounds(i).size.y);
+    return bottom;
+}
+
+// Escenarios de --equivalence: siempre con el disparo pulsado; las entradas dependen solo del
+// tiempo de juego y cambian en segundos enteros, que caen en frontera de tick a cualquier
+// frecuencia entera
+struct Scenario {
+    const char* name;
+    bool moving;      // 2 s a la izquierda, 4 s a la derecha, 2 s a la izquierda... (±300 px)
+    bool thinShields; // escudos de 12 px de alto: a 10 Hz las balas ya los cruzan en un tick
+};
+
+constexpr Scenario SCENARIOS[] = {
+    { "still", false, false },
+    { "moving", true, false },
+    { "thin shields", true, true },
+};
+
+SimInput scenarioInput(const Scenario& scenario, std::uint64_t tick, float dt) {
+    SimInput in;
+    in.fire = true;
+    if (scenario.moving) {
+        // segundo en que empieza el tick (el margen absorbe el redondeo de tick * dt)
+        const auto second = static_cast<std::int64_t>(std::floor(static_cast<double>(tick) * static_cast<double>(dt) + 1e-6));
+        const bool right = (second / 2) % 4 == 1 || (second / 2) % 4 == 2;
+        in.left = !right;
+        in.right = right;
+    }
+    return in;
+}
+
+// una partida entera del escenario
+GameLog playScenario(const Scenario& scenario, const SimConfig& config, std::uint32_t seed, float dt, const std::string& shieldPath) {
+    GameLog log;
+    SimConfig cfg = config;
+    if (scenario.thinShields) cfg.shieldSize.y = 12.f;
+    GameSim sim(cfg, seed);
+    applyShield(sim, shieldPath);
+    const auto t0 = std::chrono::steady_clock::now();
+    float shieldsTop = EQUIVALENCE_MAX_SECONDS;
+    for (const Shield& s : sim.shields()) shieldsTop = std::min(shieldsTop, s.bounds().position.y);
+    while (!sim.isOver() && static_cast<float>(sim.tick()) * dt < EQUIVALENCE_MAX_SECONDS) {
+        sim.step(scenarioInput(scenario, sim.tick(), dt), dt);
+        const float time = static_cast<float>(sim.tick()) * dt;
+        if (time < log.erosionFrom && lowestEnemy(sim) >= shieldsTop) log.erosionFrom = time;
+        for (const SimEvent& ev : sim.events()) log.events[static_cast<int>(ev.type)].push_back(EventRecord{ time, ev.value, ev.position });
+        log.sweptHits += sim.stats().sweptHits;
+    }
+    log.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    log.ticks = sim.tick();
+    log.endTime = static_cast<float>(sim.tick()) * dt;
+    return log;
+}
+
+// primera diferencia entre las dos partidas, o vacío si son equivalentes
+std::string compareGames(const GameLog& ref, const GameLog& coarse, float tolerance) {
+    char line[224];
+    const float erosion = std::min(ref.erosionFrom, coarse.erosionFrom) - tolerance;
+    for (int type = 0; type < EVENT_TYPES; ++type) {
+        std::vector<EventRecord> a = ref.events[type];
+        std::vector<EventRecord> b = coarse.events[type];
+        float cut = std::min(ref.endTime, coarse.endTime);
+        if (type == static_cast<int>(SimEventType::ShieldHit)) {
+            const auto eroding = [&](const EventRecord& e) { return e.time >= erosion; };
+            a.erase(std::remove_if(a.begin(), a.end(), eroding), a.end());
+            b.erase(std::remove_if(b.begin(), b.end(), eroding), b.end());
+            cut = std::min(cut, erosion);
+        }
+        // pegado a un corte (fin de la partida, principio de la erosión) un mismo evento puede quedar
+        // dentro en una partida y fuera en la otra: los que sobran ahí no cuentan
+        while (a.size() > b.size() && a.back().time >= cut - tolerance) a.pop_back();
+        while (b.size() > a.size() && b.back().time >= cut - tolerance) b.pop_back();
+        for (std::size_t k = 0; k < std::min(a.size(), b.size()); ++k) {
+            // la posición distingue a quién le dio: con la puntuación sola, matar a otro enemigo pasaría
+            const sf::Vector2f d = a[k].position - b[k].position;
+            if (a[k].value == b[k].value && std::abs(a[k].time - b[k].time) <= tolerance
+                && std::abs(d.x) <= EQUIVALENCE_MAX_DRIFT && std::abs(d.y) <= EQUIVALENCE_MAX_DRIFT) continue;
+            std::snprintf(line, sizeof(line), "%s #%zu: reference %.3f s value %d at (%.1f, %.1f), coarse %.3f s value %d at (%.1f, %.1f)",
+                          eventName(type), k, a[k].time, a[k].value, a[k].position.x, a[k].position.y,
+                          b[k].time, b[k].value, b[k].position.x, b[k].position.y);
+            return line;
+        }
+        if (a.size() != b.size()) {
+            std::snprintf(line, sizeof(line), "%s: %zu in the reference, %zu coarse", eventName(type), a.size(), b.size());
+            return line;
+        }
+    }
+    return {};
+}
+
+int runEquivalence(const SimConfig& config, std::uint32_t firstSeed, int games, float refHz, float coarseHz, const std::string& shieldPath) {
+    const float refDt = 1.f / refHz;
+    const float coarseDt = 1.f / coarseHz;
+    // cada evento sale al final de su tick: como mucho un tick de cada lado tarde
+    const float tolerance = refDt + coarseDt;
+    int failed = 0;
+    std::uint64_t coarseSweptTotal = 0;
+    std::cout << "equivalence " << refHz << " Hz vs " << coarseHz << " Hz, " << games << " games per scenario\n";
+    for (const Scenario& scenario : SCENARIOS) {
+        std::uint64_t events = 0, refTicks = 0, coarseTicks = 0, refSwept = 0, coarseSwept = 0;
+        double refWall = 0.0, coarseWall = 0.0;
+        int differ = 0;
+        for (int g = 0; g < games; ++g) {
+            const std::uint32_t seed = firstSeed + static_cast<std::uint32_t>(g);
+            const GameLog ref = playScenario(scenario, config, seed, refDt, shieldPath);
+            const GameLog coarse = playScenario(scenario, config, seed, coarseDt, shieldPath);
+            for (const auto& list : ref.events) events += list.size();
+            refTicks += ref.ticks; coarseTicks += coarse.ticks;
+            refSwept += ref.sweptHits; coarseSwept += coarse.sweptHits;
+            refWall += ref.wallSeconds; coarseWall += coarse.wallSeconds;
+            const std::string diff = compareGames(ref, coarse, tolerance);
+            if (diff.empty()) continue;
+            ++differ;
+            std::cout << "  " << scenario.name << ", seed " << seed << " differs: " << diff << "\n";
+        }
+        failed += differ;
+        coarseSweptTotal += coarseSwept;
+        std::cout << scenario.name << ": " << events << " events, " << differ << " differ; ticks " << refTicks << " vs " << coarseTicks
+                  << ", wall " << refWall << " s vs " << coarseWall << " s; swept hits " << refSwept << " vs " << coarseSwept << "\n";
+    }
+    // sin impactos barridos la prueba no ha pasado por el caso que tiene que demostrar
+    if (coarseSweptTotal == 0)
+        std::cout << "warning: no swept hits at " << coarseHz << " Hz (no shot outran its target); try a coarser --equivalence, e.g. 5\n";
+    std::cout << (failed > 0 ? "FAILED: " : "ok: ") << failed << " games differ\n";
+    return failed > 0 ? 4 : 0;
+}
+
+int runReplay(const std::string& path, const std::string& checksumPath, const std::string& shieldPath, const SimConfig& config) {
+    Replay replay;
+    if (!replay.load(path)) { std::cerr << "could not load replay " << path << "\n"; return 1; }
+    std::ofstream sums;
+    if (!checksumPath.empty()) {
+        sums.open(checksumPath, std::ios::trunc);
+        if (!sums) { std::cerr << "could not write " << checksumPath << "\n"; return 1; }
+    }
+    GameSim sim(config, replay.seed());
+    if (!applyShield(sim, shieldPath)) return 1;
+    if (sim.shieldShapeHash() != replay.shieldShape())
+        std::cerr << "warning: replay was recorded with a different shield shape (try --shield)\n";
+    if (sim.configHash() != replay.config())
+        std::cerr << "warning: replay was recorded with a different configuration (pass the same --cols/--rows/... flags)\n";
+    ReplayPlayer player(replay);
+    auto t0 = std::chrono::steady_clock::now();
+    while (player.step(sim)) {
+        if (sums.is_open()) writeChecksum(sums, player.tick() - 1, player.lastChecksum());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "replay: " << path << " (" << replay.ticks() << " ticks, " << 1.f / replay.dt() << " Hz, seed " << replay.seed() << ")\n"
+              << "wall: " << secs << " s, " << (secs > 0.0 ? static_cast<double>(replay.ticks()) / secs : 0.0) << " ticks/s\n"
+              << "final score: " << sim.score() << ", wave: " << sim.wave() << "\n";
+    if (player.firstDivergence()) {
+        std::cout << "DIVERGED at tick " << *player.firstDivergence() << " (" << player.divergentTicks() << " ticks differ)\n";
+        return 2;
+    }
+    std::cout << "checksums: all " << replay.ticks() << " ticks match\n";
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t ticks = 100000;
+    std::uint32_t seed = 1;
+    float hz = 120.f;
+    bool hzGiven = false;
+    PolicyKind policy = PolicyKind::Bot;
+    std::string tracePath;
+    std::string recordPath;
+    std::string replayPath;
+    std::string checksumPath;
+    std::string shieldPath;
+    bool allocCheck = false;
+    float equivalenceHz = 0.f;
+    int equivalenceGames = 20;
+    const char* notForEquivalence = nullptr; // la última opción que --equivalence no usa
+    SimConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ticks" || arg == "--policy" || arg == "--trace" || arg == "--record" || arg == "--replay"
+            || arg == "--checksums" || arg == "--alloc-check")
+            notForEquivalence = argv[i];
+        if (arg == "--ticks" && hasValue) ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && hasValue) seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--hz" && hasValue) { hz = std::strtof(argv[++i], nullptr); hzGiven = true; }
+        else if (arg == "--trace" && hasValue) tracePath = argv[++i];
+        else if (arg == "--record" && hasValue) recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+        else if (arg == "--checksums" && hasValue) checksumPath = argv[++i];
+        else if (arg == "--shield" && hasValue) shieldPath = argv[++i];
+        else if (arg == "--alloc-check") allocCheck = true;
+        else if (arg == "--equivalence" && hasValue) equivalenceHz = std::strtof(argv[++i], nullptr);
+        else if (arg == "--games" && hasValue) equivalenceGames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--policy" && hasValue) {
+            // script necesita un replay: aquí se usa --replay directamente
+            std::optional<PolicyKind> p = SimPolicy::parse(argv[++i]);
+            policy = p && *p != PolicyKind::Script ? *p : PolicyKind::Bot;
+        } else if (hasValue && applySimFlag(config, arg, argv[i + 1])) {
+            ++i;
+        } else {
+            std::cerr << "usage: galaga_headless [--ticks N] [--seed S] [--hz H] [--policy idle|random|bot] [--trace out.json]\n"
+                         "                       [--record out.grp] [--replay in.grp] [--checksums out.txt] [--shield shield.png] [--alloc-check]\n"
+                         "                       [--equivalence HZ [--hz REF] [--games N]]  (reference 240 Hz; no --ticks/--policy/...)\n"
+                         "                       " << SIM_FLAGS_USAGE << "\n";
+            return 1;
+        }
+    }
+    if (equivalenceHz > 0.f) {
+        // mejor fallar que dar por buena una prueba que no es la que se pidió
+        if (notForEquivalence) {
+            std::cerr << notForEquivalence << " has no effect with --equivalence (it plays its own scenarios)\n";
+            return 1;
+        }
+        if (!hzGiven || hz <= 0.f) hz = EQUIVALENCE_REFERENCE_HZ;
+        return runEquivalence(config, seed, equivalenceGames, hz, equivalenceHz, shieldPath);
+    }
+    // la configuración no sale del fichero (solo su huella): hay que pasar los mismos flags que al grabar
+    if (!replayPath.empty()) return runReplay(replayPath, checksumPath, shieldPath, config);
+    if (hz <= 0.f) hz = 120.f;
+    const float dt = 1.f / hz;
+    if (allocCheck && !AllocTracker::enabled()) {
+        std::cerr << "--alloc-check needs a build with GALAGA_ALLOC_TRACKING=ON\n";
+        return 1;
+    }
+
+    GameSim sim(config, seed);
+    if (!applyShield(sim, shieldPath)) return 1;
+    SimPolicy inputs(policy, seed);
+    ReplayRecorder recorder;
+    recorder.begin(seed, dt, sim.shieldShapeHash(), sim.configHash());
+    bool resetBefore = false;
+    std::ofstream sums;
+    if (!checksumPath.empty()) {
+        sums.open(checksumPath, std::ios::trunc);
+        if (!sums) { std::cerr << "could not write " << checksumPath << "\n"; return 1; }
+    }
+
+    std::uint64_t games = 0, kills = 0, shots = 0, deaths = 0, pairs = 0;
+    int bestScore = 0, bestWave = 1;
+    std::uint64_t allocTicks = 0, allocCount = 0;
+    std::vector<std::uint64_t> zonesBefore, zonesAfter;
+    zonesBefore.reserve(64);
+    zonesAfter.reserve(64);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t t = 0; t < ticks; ++t) {
+        // solo cuenta lo que es de la partida (la grabación y los checksums crecen a propósito)
+        const bool checking = allocCheck && t >= ALLOC_WARMUP_TICKS;
+        if (checking) Profiler::instance().allocsByZone(zonesBefore);
+        std::uint64_t allocs = AllocTracker::thisThread().allocs;
+        const SimInput in = inputs.next(sim);
+
+        sim.step(in, dt);
+        allocs = AllocTracker::thisThread().allocs - allocs;
+        if (!recordPath.empty()) recorder.record(in, resetBefore, sim);
+        if (sums.is_open()) writeChecksum(sums, t, foldChecksum(sim.checksum()));
+        resetBefore = false;
+        pairs += sim.stats().pairsTested;
+        for (const SimEvent& ev : sim.events()) {
+            switch (ev.type) {
+            case SimEventType::EnemyKilled: ++kills; break;
+            case SimEventType::PlayerShot: ++shots; break;
+            case SimEventType::PlayerHit: ++deaths; break;
+            default: break;
+            }
+        }
+        bestWave = std::max(bestWave, sim.wave());
+        if (sim.isOver()) {
+            ++games;
+            bestScore = std::max(bestScore, sim.score());
+            const std::uint64_t beforeReset = AllocTracker::thisThread().allocs;
+            sim.reset();
+            allocs += AllocTracker::thisThread().allocs - beforeReset;
+            resetBefore = true;
+        }
+        if (checking && allocs > 0) {
+            allocCount += allocs;
+            if (++allocTicks <= ALLOC_REPORT_LIMIT) {
+                Profiler::instance().allocsByZone(zonesAfter);
+                std::cout << "tick " << t << " allocated " << allocs << " times:";
+                printAllocZones(zonesBefore, zonesAfter);
+                std::cout << "\n";
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    bestScore = std::max(bestScore, sim.score());
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "ticks: " << ticks << " (" << hz << " Hz, seed " << seed << ")\n"
+              << "wall: " << secs << " s, " << (secs > 0.0 ? static_cast<double>(ticks) / secs : 0.0) << " ticks/s\n"
+              << "games finished: " << games << ", best score: " << bestScore << ", best wave: " << bestWave << "\n"
+              << "collision pairs tested: " << (ticks ? static_cast<double>(pairs) / static_cast<double>(ticks) : 0.0) << " per tick\n"
+              << "bullet pools high-water: player " << sim.bullets().stats().highWater << "/" << sim.bullets().stats().capacity
+              << ", enemy " << sim.enemyBullets().stats().highWater << "/" << sim.enemyBullets().stats().capacity << "\n"
+              << "shots: " << shots << ", kills: " << kills << ", player hits: " << deaths << "\n"
+              << "enemies: " << sim.config().enemyCols << "x" << sim.config().enemyRows << ", shields: " << sim.shields().size()
+              << ", sim memory: " << static_cast<double>(sim.memoryBytes()) / 1024.0 << " KB\n";
+    if (!recordPath.empty()) {
+        if (!recorder.save(recordPath)) { std::cerr << "could not write " << recordPath << "\n"; return 1; }
+        std::cout << "recorded " << recorder.ticks() << " ticks to " << recordPath << "\n";
+    }
+    if (allocCheck) {
+        std::cout << "alloc check: " << allocTicks << " of " << (ticks > ALLOC_WARMUP_TICKS ? ticks - ALLOC_WARMUP_TICKS : 0)
+                  << " ticks after warm-up allocated (" << allocCount << " allocations)\n";
+    }
+    if (!tracePath.empty()) {
+        for (const auto &z : Profiler::instance().summarize())
+            std::cout << "  " << z.name << ": p50 " << z.p50Us << " us, p99 " << z.p99Us << " us\n";
+        if (!Profiler::instance().writeChromeTrace(tracePath)) { std::cerr << "could not write " << tracePath << "\n"; return 1; }
+    }
+    return allocTicks > 0 ? 3 : 0;
+}
@@ -0,0 +1,142 @@
+#include "AssetPack.h"
+#include "AssetManifest.h"
+#include "TextureAtlas.h"
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Genera assets.pak con lo que lista AssetManifest, leído de assets/ (lo invoca la build).
+// uso: galaga_pack <dir_assets> <salida.pak>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Blob {
+    PackEntry entry{};
+    std::vector<std::uint8_t> bytes;
+};
+
+std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+bool readFile(const fs::path& path, std::vector<std::uint8_t>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// imágenes -> RGBA (reducidas a maxSize si no es 0, como las deja AssetLoader); efectos de sonido ->
+// PCM; el resto (música en streaming, fuentes) tal cual
+bool encode(const fs::path& path, const std::string& name, unsigned int maxSize, Blob& blob) {
+    const std::string ext = lower(path.extension().string());
+    const bool isMusic = name.rfind("music/", 0) == 0;
+
+    if (ext == ".png" || ext == ".jpg" || ext == ".bmp") {
+        sf::Image img;
+        if (!img.loadFromFile(path)) return false;
+        if (maxSize > 0) img = TextureAtlas::shrinkToFit(img, maxSize);
+        const sf::Vector2u size = img.getSize();
+        const std::uint8_t* px = img.getPixelsPtr();
+        blob.entry.kind = PackKind::Rgba;
+        blob.entry.param0 = size.x;
+        blob.entry.param1 = size.y;
+        blob.bytes.assign(px, px + static_cast<std::size_t>(size.x) * size.y * 4);
+        return true;
+    }
+    if (!isMusic && (ext == ".mp3" || ext == ".wav" || ext == ".ogg" || ext == ".flac")) {
+        sf::InputSoundFile file;
+        if (!file.openFromFile(path)) return false;
+        std::vector<std::int16_t> samples(static_cast<std::size_t>(file.getSampleCount()));
+        samples.resize(static_cast<std::size_t>(file.read(samples.data(), samples.size())));
+        blob.entry.kind = PackKind::Pcm;
+        blob.entry.param0 = file.getChannelCount();
+        blob.entry.param1 = file.getSampleRate();
+        const auto* raw = reinterpret_cast<const std::uint8_t*>(samples.data());
+        blob.bytes.assign(raw, raw + samples.size() * sizeof(std::int16_t));
+        return true;
+    }
+    blob.entry.kind = PackKind::Raw;
+    return readFile(path, blob.bytes);
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: galaga_pack <assets_dir> <out.pak>\n";
+        return 1;
+    }
+    const fs::path root = argv[1];
+    const fs::path outPath = argv[2];
+
+    // solo lo que carga el juego, en un orden fijo: el mismo árbol produce el mismo paquete
+    std::vector<std::pair<std::string, unsigned int>> assets;
+    for (const char* name : AssetManifest::ATLAS_SPRITES) assets.emplace_back(AssetManifest::spritePath(name), AssetManifest::ATLAS_SPRITE_MAX);
+    for (const char* name : { AssetManifest::SHIELD, AssetManifest::LASER_SOUND, AssetManifest::EXPLOSION_SOUND,
+                              AssetManifest::MUSIC, AssetManifest::FONT })
+        assets.emplace_back(name, 0u);
+
+    std::vector<Blob> blobs;
+    blobs.reserve(assets.size());
+    for (const auto& [name, maxSize] : assets) {
+        if (name.size() >= sizeof(PackEntry::name)) {
+            std::cerr << "name too long for the pack index: " << name << "\n";
+            return 1;
+        }
+        const fs::path path = root / name;
+        Blob blob;
+        std::memcpy(blob.entry.name, name.c_str(), name.size() + 1);
+        if (!encode(path, name, maxSize, blob)) {
+            std::cerr << "could not encode " << path << "\n";
+            return 1;
+        }
+        blobs.push_back(std::move(blob));
+    }
+
+    auto alignUp = [](std::uint64_t v) { return (v + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN; };
+    std::uint64_t offset = alignUp(sizeof(PackHeader) + blobs.size() * sizeof(PackEntry));
+    for (Blob& b : blobs) {
+        b.entry.offset = offset;
+        b.entry.size = b.bytes.size();
+        offset = alignUp(offset + b.bytes.size());
+    }
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "could not write " << outPath << "\n";
+        return 1;
+    }
+    PackHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.count = static_cast<std::uint32_t>(blobs.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const Blob& b : blobs) out.write(reinterpret_cast<const char*>(&b.entry), sizeof(b.entry));
+
+    const char zeros[PACK_ALIGN] = {};
+    std::uint64_t pos = sizeof(PackHeader) + blobs.size() * sizeof(PackEntry);
+    for (const Blob& b : blobs) {
+        out.write(zeros, static_cast<std::streamsize>(b.entry.offset - pos));
+        out.write(reinterpret_cast<const char*>(b.bytes.data()), static_cast<std::streamsize>(b.bytes.size()));
+        pos = b.entry.offset + b.bytes.size();
+    }
+    if (!out) {
+        std::cerr << "write failed: " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "packed " << blobs.size() << " assets into " << outPath << " (" << pos << " bytes)\n";
+    return 0;
+}